@@ -25,8 +25,10 @@
 
     "variables" : {
         "gpio" : "true",
+        "wiringpi" : "true", # wiringPi GPIO backend, only needed on kernels older than 5.10
         "wiringPi-lib" : "-lwiringPi", # wiringPi static lib, ignore if not used
-        "i2c-bus-file" : "/dev/i2c-1"  # i2c file to use for i2c sensors
+        "i2c-bus-file" : "/dev/i2c-1",  # default i2c file to use for i2c sensors without a bus
+        "gpio-chip-file" : "/dev/gpiochip0" # GPIO chip used to timestamp the edges of the GPIO sensors
     },
 
     "targets": [
@@ -35,24 +37,49 @@
             "sources": [
                 "src/format.cc",
                 "src/wrapper_sensor.cc",
+                "src/wrapper_bus.cc",
                 "src/plugin.cc",
                 "src/sensor.cc",
                 "src/sensor_result.cc",
                 "src/i2c_sensor.cc",
+                "src/i2c_bus.cc",
+                "src/i2c_transaction.cc",
+                "src/i2c_scan.cc",
+                "src/i2c_transport.cc",
+                "src/i2c_dev_transport.cc",
+                "src/i2c_sim_transport.cc",
+                "src/i2c_trace_transport.cc",
+                "src/BMP180_sim.cc",
+                "src/TSL2561_sim.cc",
                 "src/TSL2561.cc",
-                "src/BMP180.cc"
+                "src/TSL2561_lux.cc",
+                "src/BMP180.cc",
+                "src/BMP180_compensation.cc",
+                "src/DHT_decoder.cc"
             ],
             "defines": [ "I2C_BUS_FILE=\"<(i2c-bus-file)\"" ],
             'conditions': [
-                [   # raspi-sensor with GPIO activated (note that GPIO requires wiringPi)
+                [   # raspi-sensor with GPIO activated
                     'gpio == "true"', {
                         "sources": [
                             "src/gpio_sensor.cc",
-                            "src/DHT22.cc",
-                            "src/DHT11.cc",
+                            "src/gpio_backend.cc",
+                            "src/gpio_chardev.cc",
+                            "src/gpio_sim_backend.cc",
+                            "src/DHT_sim.cc",
+                            "src/PIR_sim.cc",
+                            "src/DHT.cc",
                             "src/PIR.cc"
                         ],
-                        "defines": [ "USE_GPIO" ],
+                        "defines": [ "USE_GPIO", "GPIO_CHIP_FILE=\"<(gpio-chip-file)\"" ]
+                    }
+                ],
+                [   # wiringPi GPIO backend
+                    'gpio == "true" and wiringpi == "true"', {
+                        "sources": [
+                            "src/gpio_wiringpi_backend.cc"
+                        ],
+                        "defines": [ "USE_WIRINGPI" ],
                         "libraries": [ "<(wiringPi-lib)" ]
                     }
                 ]
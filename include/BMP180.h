@@ -8,8 +8,14 @@
 #ifndef H_BMP180
 #define H_BMP180
 
+#include <chrono>
+
 #include "i2c_sensor.h"
 #include "sensor_result.h"
+#include "BMP180_compensation.h"
+
+// Delay between two polls of the end of a conversion (us)
+#define BMP180_POLL_INTERVAL 250
 
 /**
  * @namespace sensor
@@ -29,8 +35,9 @@ namespace sensor {
              *  @brief Constructor
              *  @param address Address of the sensor
              *  @param name    Name of the sensor
+             *  @param options Options of the sensor
              */
-            BMP180_sensor(uint16_t, std::string);
+            BMP180_sensor(uint16_t, std::string, const sensorOptions&);
 
             /**
              *  @brief Return the type of the sensor (BMP180)
@@ -43,9 +50,17 @@ namespace sensor {
             virtual ~BMP180_sensor();
 
             /**
-             *  @brief Prepare a result fetching. May throw an exception if any error occures
+             *  @brief Prepare a result fetching, reading the calibration data on the first call. May
+             *  throw an exception if any error occures
              */
             void prepare();
+
+            /**
+             *  @brief Read the calibration data of the sensor again, in a single burst. The calibration
+             *  data is factory fixed, and only needs to be read again if the sensor was replaced. May
+             *  throw an exception if any error occures, or if the data read is invalid
+             */
+            void recalibrate();
             
             /**
              *  @brief Fetch a result. May throw an exception if any error occures
@@ -59,30 +74,40 @@ namespace sensor {
              *
              * @return A pointer to the created sensor
              */
-            static sensor* create(int, const std::string&);
+            static sensor* create(int, const std::string&, const sensorOptions&);
             
          private:
-            int16_t ac1;
-            int16_t ac2;
-            int16_t ac3;
-            uint16_t ac4;
-            uint16_t ac5;
-            uint16_t ac6;
-            int16_t b1;
-            int16_t b2;
-            int16_t mb;
-            int16_t mc;
-            int16_t md;
-        
+            bmp180Calibration calibration;
+
+            bool calibrated = false; // If the calibration data has been read
+
             int32_t b5;
 
+            // Temperature compensation (b5) reuse, between pressure samples
+            unsigned temperatureRefresh;                           // Pressure samples between two temperature conversions, or 0
+            std::chrono::milliseconds temperatureMaxAge;           // Maximum age of b5, or 0
+            unsigned pressureSamples = 0;                          // Pressure samples since the last temperature conversion
+            bool compensated = false;                              // If b5 is known
+            std::chrono::steady_clock::time_point compensationTime; // Time of the last temperature conversion
+
             uint16_t oss = 0;
-        
+
+            // Wait before the first poll of each conversion (temperature, then pressure for each
+            // oversampling), adapted to the time the sensor actually takes
+            int conversionWait[5] = { 3000, 3000, 5000, 9000, 17000 };
+
+            /**
+             * @brief Start a conversion, wait for its end by polling the SCO bit, and read its result
+             * @param command The measurement control value
+             * @param mode    The conversion (0 for temperature, 1 + oss for pressure)
+             * @param buffer  The buffer to read the result into
+             * @param len     The length of the result, from 0xF6
+             */
+            void convert(uint8_t, unsigned, uint8_t*, size_t);
+
             int32_t readUT();
             int32_t readUP();
-            
-            float convertTemperature(uint16_t ut);
-            long convertPressure(unsigned long up);
+
     };
 
 }
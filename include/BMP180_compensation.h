@@ -0,0 +1,103 @@
+/**
+ * @file BMP180_compensation.h
+ * @brief Stateless compensation of the raw BMP180 temperatures and pressures
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#ifndef H_BMP180_COMPENSATION
+#define H_BMP180_COMPENSATION
+
+#include <inttypes.h>
+#include <stddef.h>
+
+// Number of samples compensated together by the batch compensation
+#define BMP180_COMPENSATION_BLOCK 256
+
+/**
+ * @namespace sensor
+ *
+ * Name space used to store every class and functions related to the sensors
+ */
+namespace sensor {
+
+    /**
+     * @brief Struct of the calibration data of a BMP180, as stored in its EEPROM
+     */
+    struct bmp180Calibration {
+        int16_t ac1;
+        int16_t ac2;
+        int16_t ac3;
+        uint16_t ac4;
+        uint16_t ac5;
+        uint16_t ac6;
+        int16_t b1;
+        int16_t b2;
+        int16_t mb;
+        int16_t mc;
+        int16_t md;
+    };
+
+    /**
+     * @class BMP180_compensation
+     * @brief Stateless compensation of the raw BMP180 temperatures and pressures, following
+     * the integer algorithm of the datasheet
+     *
+     *  The batch version works on separate arrays of raw temperatures and pressures. Samples are
+     *  processed by blocks, computing each step of the algorithm for the whole block before the
+     *  next one, so the loops stay free of branches and the steps without division can be
+     *  vectorized
+     */
+    class BMP180_compensation {
+
+        public:
+            /**
+             * @brief Compute the temperature compensation factor (b5) of a raw temperature
+             * @param  calibration The calibration data of the sensor
+             * @param  ut          The raw temperature
+             * @return             The compensation factor
+             */
+            static int32_t computeB5(const bmp180Calibration&, int32_t);
+
+            /**
+             * @brief Check that a raw temperature can be compensated, i.e. that none of the
+             * divisors of the algorithm is 0 with this calibration data
+             * @param  calibration The calibration data of the sensor
+             * @param  ut          The raw temperature
+             * @return             If the temperature and its pressures can be compensated
+             */
+            static bool isComputable(const bmp180Calibration&, int32_t);
+
+            /**
+             * @brief Return the temperature of a compensation factor
+             * @param  b5 The compensation factor
+             * @return    The temperature, in degree Celsius
+             */
+            static float temperature(int32_t);
+
+            /**
+             * @brief Compensate a raw pressure
+             * @param  calibration The calibration data of the sensor
+             * @param  b5          The compensation factor of the temperature
+             * @param  up          The raw pressure
+             * @param  oss         The oversampling of the raw pressure
+             * @return             The pressure, in Pascal
+             */
+            static int32_t pressure(const bmp180Calibration&, int32_t, int32_t, uint16_t);
+
+            /**
+             * @brief Compensate arrays of raw temperatures and pressures, each pressure being
+             * compensated with the temperature of the same index
+             * @param calibration  The calibration data of the sensor
+             * @param oss          The oversampling of the raw pressures
+             * @param count        The number of samples
+             * @param ut           The raw temperatures
+             * @param up           The raw pressures
+             * @param temperatures The temperatures computed, in degree Celsius
+             * @param pressures    The pressures computed, in Pascal
+             */
+            static void compensate(const bmp180Calibration&, uint16_t, size_t, const int32_t*, const int32_t*, float*, int32_t*);
+    };
+}
+
+#endif // H_BMP180_COMPENSATION
@@ -0,0 +1,69 @@
+/**
+ * @file BMP180_sim.h
+ * @brief Simulated BMP180 device, to be plugged on a simulated I2C bus
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#ifndef H_BMP180_SIM
+#define H_BMP180_SIM
+
+#include <chrono>
+
+#include "i2c_sim_transport.h"
+
+/**
+ * @namespace sensor
+ *
+ * Name space used to store every class and functions related to the sensors
+ */
+namespace sensor {
+
+    /**
+     * @class BMP180_sim_device
+     * @brief Register map model of a BMP180
+     *
+     *  The calibration EEPROM (0xAA to 0xBF) holds the datasheet example values, and the
+     *  conversions started with 0xF4 take the datasheet maximum time to complete. Until then, the
+     *  SCO bit of 0xF4 is set and 0xF6 to 0xF8 hold the previous conversion. With the default
+     *  raw values, the conversions give 15.0 °C and 69964 Pa
+     */
+    class BMP180_sim_device : public i2c_sim_device {
+
+        public:
+            /**
+             *  @brief Constructor
+             */
+            BMP180_sim_device();
+
+            /**
+             *  @brief Destructor
+             */
+            virtual ~BMP180_sim_device();
+
+            void read(uint8_t, uint8_t*, size_t);
+            void write(uint8_t, uint8_t);
+
+            /**
+             * @brief Set the raw values returned by the next conversions
+             * @param ut The uncompensated temperature
+             * @param up The uncompensated pressure, in ultra low power mode (oss = 0)
+             */
+            void setRawValues(int32_t, int32_t);
+
+        private:
+            /**
+             * @brief Complete the running conversion, if its time has elapsed
+             */
+            void update();
+
+            uint8_t registers[256]; // Register map
+            int32_t ut;             // Uncompensated temperature
+            int32_t up;             // Uncompensated pressure, with oss = 0
+            bool converting;        // If a conversion is running
+
+            std::chrono::steady_clock::time_point conversionEnd; // End of the running conversion
+    };
+}
+
+#endif // H_BMP180_SIM
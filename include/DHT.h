@@ -0,0 +1,170 @@
+/**
+ * @file DHT.h
+ * @brief Class for DHT sensors (DHT11, DHT21, DHT22 and AM2302). A DHT uses the GPIO bus on the raspberry
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#ifndef H_DHT
+#define H_DHT
+
+#include <chrono>
+#include <mutex>
+#include <list>
+
+#include "gpio_sensor.h"
+#include "sensor_result.h"
+#include "DHT_decoder.h"
+
+// Maximum duration of the answer of the sensor (us), and number of consecutive failed reads before failing
+#define DHT_TIMEOUT 10000
+#define DHT_RETRIES 5
+
+/**
+ * @namespace sensor
+ *
+ * Name space used to store every class and functions related to the sensors
+ */
+namespace sensor {
+
+    /**
+     * @brief Enum of the DHT variants
+     */
+    enum dhtVariant {
+        VARIANT_DHT11,
+        VARIANT_DHT21, // Also sold as AM2301
+        VARIANT_DHT22,
+        VARIANT_AM2302 // Wired DHT22
+    };
+
+    typedef enum dhtVariant dhtVariant;
+
+    /**
+     * @brief Encoding of the DHT11 : integral humidity (%) and temperature (°C) in the first and
+     * third bytes
+     */
+    struct dht11Encoding {
+        static constexpr float humidity(const uint8_t* data) {
+            return (float) data[0];
+        }
+
+        static constexpr float temperature(const uint8_t* data) {
+            return (float) (data[2] & 0x7F);
+        }
+    };
+
+    /**
+     * @brief Encoding of the DHT21 and DHT22 : humidity (0.1%) and temperature (0.1°C) on 16 bits, the
+     * highest bit of the temperature being its sign
+     */
+    struct dht22Encoding {
+        static constexpr float humidity(const uint8_t* data) {
+            return (float) ((((unsigned) data[0] << 8) | data[1]) / 10.0);
+        }
+
+        static constexpr float temperature(const uint8_t* data) {
+            return (float) ((data[2] & 0x80 ? -1 : 1) * (int) (((unsigned) (data[2] & 0x7F) << 8) | data[3]) / 10.0);
+        }
+    };
+
+    /**
+     * @brief Traits of each DHT variant : name, encoding, length of the start signal (us) and minimum
+     * interval between two samplings (ms)
+     */
+    template<dhtVariant V> struct dhtTraits;
+
+    template<> struct dhtTraits<VARIANT_DHT11> : dht11Encoding {
+        static constexpr const char* name() { return "DHT11"; }
+        static constexpr unsigned start() { return 18000; }
+        static constexpr unsigned interval() { return 1000; }
+    };
+
+    template<> struct dhtTraits<VARIANT_DHT21> : dht22Encoding {
+        static constexpr const char* name() { return "DHT21"; }
+        static constexpr unsigned start() { return 1100; }
+        static constexpr unsigned interval() { return 2000; }
+    };
+
+    template<> struct dhtTraits<VARIANT_DHT22> : dht22Encoding {
+        static constexpr const char* name() { return "DHT22"; }
+        static constexpr unsigned start() { return 1100; }
+        static constexpr unsigned interval() { return 2000; }
+    };
+
+    template<> struct dhtTraits<VARIANT_AM2302> : dht22Encoding {
+        static constexpr const char* name() { return "AM2302"; }
+        static constexpr unsigned start() { return 1100; }
+        static constexpr unsigned interval() { return 2000; }
+    };
+
+    /**
+     * @class DHT_sensor
+     * @brief Class for DHT sensors, specialized at compile time by variant
+     *
+     *  Every variant shares the same capture and decoding, and only differs by its traits. A
+     *  sampling is never started before the minimum interval of the variant since the previous one:
+     *  instead of waiting, the fetch fails and asks to be retried once the interval has elapsed.
+     *  The same goes for a failed read, until too many reads failed in a row
+     */
+    template<dhtVariant V>
+    class DHT_sensor : public gpio_sensor {
+
+        public:
+            typedef dhtTraits<V> traits;
+
+            /**
+             *  @brief Constructor
+             *  @param pin     Value of which pin to read data on
+             *  @param name    Name of the sensor
+             *  @param backend  GPIO backend of the pin, empty for the default one
+             *  @param lastGood Maximum age of the last good values, returned when the reads fail (ms), or 0
+             */
+            DHT_sensor(unsigned, std::string, const std::string& = "", unsigned = 0);
+
+            /**
+             *  @brief Destructor
+             */
+            virtual ~DHT_sensor();
+
+            /**
+             *  @brief Return the type of the sensor (e.g. DHT22)
+             */
+            const std::string getType();
+
+            /**
+             *  @brief Fetch a result. May throw an exception if any error occures
+             *
+             * @return The list of results fetched from the sensor.
+             */
+            std::list<result> getResults();
+
+            /**
+             * @brief Static creator for the sensor
+             *
+             * @return A pointer to the created sensor
+             */
+            static sensor* create(int, const std::string&, const sensorOptions&);
+
+         private:
+            /**
+             * @brief Sample the sensor. Its minimum interval should have elapsed
+             * @param  humidity    Where to store the humidity (%)
+             * @param  temperature Where to store the temperature (°C)
+             * @return             If the answer was valid
+             */
+            bool readData(float*, float*);
+
+            std::chrono::steady_clock::time_point lastSampling; // Start of the last sampling
+            unsigned failures;            // Failed reads in a row
+            unsigned lastGoodMaxAge;      // Maximum age of the last good values (ms), or 0
+            std::list<result> lastGood;   // Last good values
+            std::mutex lock;              // Protects the sampling state
+    };
+
+    typedef DHT_sensor<VARIANT_DHT11> DHT11_sensor;
+    typedef DHT_sensor<VARIANT_DHT21> DHT21_sensor;
+    typedef DHT_sensor<VARIANT_DHT22> DHT22_sensor;
+    typedef DHT_sensor<VARIANT_AM2302> AM2302_sensor;
+}
+
+#endif // H_DHT
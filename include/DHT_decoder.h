@@ -0,0 +1,67 @@
+/**
+ * @file DHT_decoder.h
+ * @brief Stateless decoding of the pulses answered by DHT sensors
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#ifndef H_DHT_DECODER
+#define H_DHT_DECODER
+
+#include <inttypes.h>
+#include <stddef.h>
+
+// High pulses of an answer : at most the release of the pin, the acknowledgment and the 40 data bits
+#define DHT_PULSES 42
+#define DHT_BITS 40
+
+// Nominal width of a data bit (us), and width above which a bit is a 1 (us)
+#define DHT_ZERO_WIDTH 27
+#define DHT_ONE_WIDTH 70
+#define DHT_BIT_THRESHOLD 48
+
+/**
+ * @namespace sensor
+ *
+ * Name space used to store every class and functions related to the sensors
+ */
+namespace sensor {
+
+    /**
+     * @brief Struct of the high pulses answered by a DHT sensor to a start signal
+     */
+    struct dhtCapture {
+        unsigned widths[DHT_PULSES]; // Width of each pulse (us)
+        unsigned count;              // Number of pulses captured
+    };
+
+    /**
+     * @brief Struct of a decoded DHT answer
+     */
+    struct dhtFrame {
+        uint8_t data[5];  // Bytes of the answer, the last one being the checksum of the others
+        bool valid;       // If the 40 bits were captured, and the checksum matches
+        float confidence; // Margin of the least certain bit, from 0 (at the threshold) to 1 (nominal width or beyond)
+    };
+
+    /**
+     * @class DHT_decoder
+     * @brief Stateless decoding of the pulses answered by DHT sensors
+     *
+     *  The data bits are the last 40 pulses captured, so that the release of the pin and the
+     *  acknowledgment may be missed. The decoding only depends on the widths, to be fuzzed and
+     *  benchmarked on recorded captures
+     */
+    class DHT_decoder {
+
+        public:
+            /**
+             * @brief Decode a capture
+             * @param  capture The capture
+             * @return         The answer decoded, valid or not
+             */
+            static dhtFrame decode(const dhtCapture&);
+    };
+}
+
+#endif // H_DHT_DECODER
@@ -0,0 +1,90 @@
+/**
+ * @file DHT_sim.h
+ * @brief Simulated DHT11 and DHT22 devices, to be wired to a simulated GPIO pin
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#ifndef H_DHT_SIM
+#define H_DHT_SIM
+
+#include <cmath>
+#include <random>
+#include <algorithm>
+
+#include "gpio_sim_backend.h"
+
+/**
+ * @namespace sensor
+ *
+ * Name space used to store every class and functions related to the sensors
+ */
+namespace sensor {
+
+    /**
+     * @class DHT_sim_device
+     * @brief Waveform model of a DHT11 or a DHT22
+     *
+     *  A start signal long enough is answered with the release of the pin, the acknowledgment
+     *  (80 us low, 80 us high), then the 40 bits of the measure (50 us low, then 26 us high for a
+     *  0 or 70 us high for a 1), and a last low pulse. Each duration of the waveform can be
+     *  randomly shifted, to emulate the jitter of the sensor. The random sequence is always the
+     *  same, so the failures can be reproduced. The device can also be intermittent, ignoring some
+     *  of the start signals
+     */
+    class DHT_sim_device : public gpio_sim_device {
+
+        public:
+            /**
+             *  @brief Constructor
+             *  @param dht11  If the device is a DHT11, otherwise a DHT22
+             *  @param jitter Maximum shift of each duration of the waveform (us)
+             */
+            DHT_sim_device(bool, unsigned);
+
+            /**
+             *  @brief Destructor
+             */
+            virtual ~DHT_sim_device();
+
+            bool level();
+            size_t answer(unsigned, gpioEdge*, size_t);
+
+            /**
+             * @brief Set the simulated measure
+             * @param humidity    The relative humidity (%)
+             * @param temperature The temperature (°C)
+             */
+            void setMeasure(float, float);
+
+            /**
+             * @brief Make the device answer some start signals, then ignore some, repeatedly
+             * @param answers  Number of start signals answered
+             * @param failures Number of start signals ignored afterward, or 0 to always answer
+             */
+            void setFailures(unsigned, unsigned);
+
+        private:
+            /**
+             * @brief Add an edge after a duration, shifted by the jitter
+             * @param edges    Where to store the edges
+             * @param count    The number of edges stored, updated
+             * @param max      Maximum number of edges to store
+             * @param time     Time of the last edge (ns), updated
+             * @param duration The duration (us)
+             * @param rising   If the edge is rising
+             */
+            void edge(gpioEdge*, size_t&, size_t, uint64_t&, unsigned, bool);
+
+            bool dht11;         // If the device is a DHT11
+            unsigned jitter;    // Maximum shift of each duration (us)
+            float humidity;     // Simulated relative humidity (%)
+            float temperature;  // Simulated temperature (°C)
+            unsigned answers;   // Start signals answered in a row
+            unsigned failures;  // Start signals ignored in a row, or 0
+            unsigned signals;   // Start signals received
+            std::minstd_rand random; // Source of the jitter
+    };
+}
+
+#endif // H_DHT_SIM
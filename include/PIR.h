@@ -30,9 +30,11 @@ namespace sensor {
         public:
             /**
              *  @brief Constructor
-             *  @param pin : Value of which pin to read data on
+             *  @param pin     Value of which pin to read data on
+             *  @param name    Name of the sensor
+             *  @param backend GPIO backend of the pin, empty for the default one
              */
-            PIR_sensor(unsigned, std::string);
+            PIR_sensor(unsigned, std::string, const std::string& = "");
 
             /**
              *  @brief Destructor
@@ -56,7 +58,7 @@ namespace sensor {
              *
              * @return A pointer to the created sensor
              */
-            static sensor* create(int, const std::string&);
+            static sensor* create(int, const std::string&, const sensorOptions&);
 
          private:
             int readData(int* piDetection);
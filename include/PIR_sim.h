@@ -0,0 +1,54 @@
+/**
+ * @file PIR_sim.h
+ * @brief Simulated PIR device, to be wired to a simulated GPIO pin
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#ifndef H_PIR_SIM
+#define H_PIR_SIM
+
+#include <chrono>
+
+#include "gpio_sim_backend.h"
+
+/**
+ * @namespace sensor
+ *
+ * Name space used to store every class and functions related to the sensors
+ */
+namespace sensor {
+
+    /**
+     * @class PIR_sim_device
+     * @brief Level model of a PIR
+     *
+     *  The device detects a motion at a fixed period : its output is high for the first part of
+     *  each period, starting from the creation of the device, and low for the rest of it
+     */
+    class PIR_sim_device : public gpio_sim_device {
+
+        public:
+            /**
+             *  @brief Constructor
+             *  @param period Period of the motions (ms)
+             *  @param high   Duration of each motion (ms)
+             */
+            PIR_sim_device(unsigned = 10000, unsigned = 3000);
+
+            /**
+             *  @brief Destructor
+             */
+            virtual ~PIR_sim_device();
+
+            bool level();
+
+        private:
+            std::chrono::milliseconds period; // Period of the motions
+            std::chrono::milliseconds high;   // Duration of each motion
+
+            std::chrono::steady_clock::time_point creation; // Start of the first period
+    };
+}
+
+#endif // H_PIR_SIM
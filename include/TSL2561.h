@@ -9,73 +9,43 @@
 #ifndef H_TSL2561
 #define H_TSL2561
 
+#include <chrono>
+
 #include "i2c_sensor.h"
 #include "sensor_result.h"
+#include "TSL2561_lux.h"
 
 // Defines for the TSL2561 sensor
 #define  TSL2561_CONTROL  0x80
 #define  TSL2561_TIMING   0x81
 #define  TSL2561_INTERRUPT 0x86
+#define  TSL2561_THRESHLOWLOW 0x82
+#define  TSL2561_THRESHLOWHIGH 0x83
+#define  TSL2561_THRESHHIGHLOW 0x84
+#define  TSL2561_THRESHHIGHHIGH 0x85
 #define  TSL2561_CHANNAL0L 0x8C
 #define  TSL2561_CHANNAL0H 0x8D
 #define  TSL2561_CHANNAL1L 0x8E
 #define  TSL2561_CHANNAL1H 0x8F
+#define  TSL2561_WORD     0x20  // Command bit for word (two bytes) read
+
+#define  TSL2561_POWER_ON 0x03
+#define  TSL2561_GAIN_16X 0x10  // Gain bit of the timing register
+#define  TSL2561_CLEAR    0x40  // Command bit clearing the pending interrupt
+#define  TSL2561_INTERRUPT_LEVEL 0x10 // Level interrupt, when the broadband channel leaves the thresholds
+#define  TSL2561_PERSIST  0x01  // Interrupt as soon as an integration leaves the thresholds
+
+// Margin over the integration time before reading a new sample, for the oscillator tolerance (%)
+#define TSL2561_INTEGRATION_MARGIN 10
 
-#define LUX_SCALE 14           // scale by 2^14
-#define RATIO_SCALE 9          // scale ratio by 2^9
-#define CH_SCALE 10            // scale channel values by 2^10
-#define CHSCALE_TINT0 0x7517   // 322/11 * 2^CH_SCALE
-#define CHSCALE_TINT1 0x0fe7   // 322/81 * 2^CH_SCALE
-
-#define K1T 0x0040   // 0.125 * 2^RATIO_SCALE
-#define B1T 0x01f2   // 0.0304 * 2^LUX_SCALE
-#define M1T 0x01be   // 0.0272 * 2^LUX_SCALE
-#define K2T 0x0080   // 0.250 * 2^RATIO_SCA
-#define B2T 0x0214   // 0.0325 * 2^LUX_SCALE
-#define M2T 0x02d1   // 0.0440 * 2^LUX_SCALE
-#define K3T 0x00c0   // 0.375 * 2^RATIO_SCALE
-#define B3T 0x023f   // 0.0351 * 2^LUX_SCALE
-#define M3T 0x037b   // 0.0544 * 2^LUX_SCALE
-#define K4T 0x0100   // 0.50 * 2^RATIO_SCALE
-#define B4T 0x0270   // 0.0381 * 2^LUX_SCALE
-#define M4T 0x03fe   // 0.0624 * 2^LUX_SCALE
-#define K5T 0x0138   // 0.61 * 2^RATIO_SCALE
-#define B5T 0x016f   // 0.0224 * 2^LUX_SCALE
-#define M5T 0x01fc   // 0.0310 * 2^LUX_SCALE
-#define K6T 0x019a   // 0.80 * 2^RATIO_SCALE
-#define B6T 0x00d2   // 0.0128 * 2^LUX_SCALE
-#define M6T 0x00fb   // 0.0153 * 2^LUX_SCALE
-#define K7T 0x029a   // 1.3 * 2^RATIO_SCALE
-#define B7T 0x0018   // 0.00146 * 2^LUX_SCALE
-#define M7T 0x0012   // 0.00112 * 2^LUX_SCALE
-#define K8T 0x029a   // 1.3 * 2^RATIO_SCALE
-#define B8T 0x0000   // 0.000 * 2^LUX_SCALE
-#define M8T 0x0000   // 0.000 * 2^LUX_SCALE
-
-#define K1C 0x0043   // 0.130 * 2^RATIO_SCALE
-#define B1C 0x0204   // 0.0315 * 2^LUX_SCALE
-#define M1C 0x01ad   // 0.0262 * 2^LUX_SCALE
-#define K2C 0x0085   // 0.260 * 2^RATIO_SCALE
-#define B2C 0x0228   // 0.0337 * 2^LUX_SCALE
-#define M2C 0x02c1   // 0.0430 * 2^LUX_SCALE
-#define K3C 0x00c8   // 0.390 * 2^RATIO_SCALE
-#define B3C 0x0253   // 0.0363 * 2^LUX_SCALE
-#define M3C 0x0363   // 0.0529 * 2^LUX_SCALE
-#define K4C 0x010a   // 0.520 * 2^RATIO_SCALE
-#define B4C 0x0282   // 0.0392 * 2^LUX_SCALE
-#define M4C 0x03df   // 0.0605 * 2^LUX_SCALE
-#define K5C 0x014d   // 0.65 * 2^RATIO_SCALE
-#define B5C 0x0177   // 0.0229 * 2^LUX_SCALE
-#define M5C 0x01dd   // 0.0291 * 2^LUX_SCALE
-#define K6C 0x019a   // 0.80 * 2^RATIO_SCALE
-#define B6C 0x0101   // 0.0157 * 2^LUX_SCALE
-#define M6C 0x0127   // 0.0180 * 2^LUX_SCALE
-#define K7C 0x029a   // 1.3 * 2^RATIO_SCALE
-#define B7C 0x0037   // 0.00338 * 2^LUX_SCALE
-#define M7C 0x002b   // 0.00260 * 2^LUX_SCALE
-#define K8C 0x029a   // 1.3 * 2^RATIO_SCALE
-#define B8C 0x0000   // 0.000 * 2^LUX_SCALE
-#define M8C 0x0000   // 0.000 * 2^LUX_SCALE
+// Auto-ranging : a reading above this part of the maximum count uses a less sensitive range for the
+// next one, and a reading which would stay below this part of the maximum count of a more sensitive
+// range uses it (%)
+#define TSL2561_RANGE_HIGH 80
+#define TSL2561_RANGE_LOW 50
+
+// Number of ranges : every combination of gain and integration time
+#define TSL2561_RANGES 6
 
 /**
  * @namespace sensor
@@ -84,6 +54,8 @@
  */
 namespace sensor {
 
+    class gpio_backend; // Used for the interrupt pin in event mode
+
     /**
      * @class TSL2561_sensor
      * @brief Class for TSL2561 sensors
@@ -94,8 +66,10 @@ namespace sensor {
             /**
              *  @brief Constructor
              *  @param address : Address of the sensor
+             *  @param name    : Name of the sensor
+             *  @param options : Options of the sensor
              */
-            TSL2561_sensor(uint16_t, std::string);
+            TSL2561_sensor(uint16_t, std::string, const sensorOptions&);
 
             /**
              *  @brief Destructor
@@ -108,8 +82,8 @@ namespace sensor {
             const std::string getType();
 
             /**
-             *  @brief Prepare the sensor before fetching any result. This method must be called before any result
-             *  is requested. May throw exception 
+             *  @brief Prepare the sensor before fetching any result, powering it up in continuous integration.
+             *  Only the registers changed since the last call are written. May throw exception
              */
             void prepare();
 
@@ -125,21 +99,93 @@ namespace sensor {
              *
              * @return A pointer to the created sensor
              */
-            static sensor* create(int, const std::string&);
+            static sensor* create(int, const std::string&, const sensorOptions&);
             
          private:
+            tsl2561Package package;  // Package of the sensor
+            int interruptPin;        // Pin of the interrupt line in event mode, or -1
+            unsigned threshold;      // Variation of the light triggering an event (%)
+            bool armed = false;      // If the thresholds are set around the last reading
+            gpio_backend* interruptBackend = NULL; // GPIO backend of the interrupt pin, once configured
+
+            unsigned range = 4;      // Range, from the least to the most sensitive
+            uint8_t gain = 1;        // Gain of the range, 0 for 1x or 1 for 16x
+            uint8_t integration = 1; // Integration time of the range, 0 for 13.7ms, 1 for 101ms or 2 for 402ms
+
+            // Shadow copy of the configuration registers, -1 if unknown
+            int control = -1;
+            int timing = -1;
+            int interrupt = -1;
+
+            std::chrono::steady_clock::time_point integrationStart; // Start of the integrations with the current configuration
+            std::chrono::steady_clock::time_point lastRead;         // Time of the last read of the channels
+
             /**
-             * Read raw data from the I2C sensor
-             * @param channel0 Data read in the first channel
-             * @param channel1 Data read in the second channel
+             * Write the configuration registers which differ from their shadow copy, in a single transaction
+             * @param control   The value of the control register
+             * @param timing    The value of the timing register
+             * @param interrupt The value of the interrupt register
              */
-            void readRawData(uint32_t*, uint32_t*);
+            void configure(uint8_t, uint8_t, uint8_t);
+
+            /**
+             * Wait until an integration is completed since the last read, or since the configuration change
+             */
+            void waitIntegration();
 
             /**
-             * Read raw data and convert it to a readable lux value
-             * @return The lux value read from the sensor
+             * Select the range (gain and integration time) used for the next readings
+             * @param range The range, from the least to the most sensitive
              */
-            uint32_t readData(uint16_t iGain, uint16_t tInt, uint16_t iType);
+            void setRange(unsigned);
+
+            /**
+             * Select the range of the next reading from the headroom of the last one : the most
+             * sensitive range keeping the reading out of saturation
+             * @param channel0 The broadband channel of the last reading
+             */
+            void adjustRange(uint32_t);
+
+            /**
+             * Return the sensitivity of a range, relative to the least sensitive one
+             * @param range The range
+             * @return The sensitivity of the range
+             */
+            static uint32_t sensitivity(unsigned);
+
+            /**
+             * Return if a range saturates at a higher light than another one. The maximum count
+             * depends on the integration time, so a more sensitive range doesn't always saturate first
+             * @param range The range
+             * @param other The other range
+             * @return If the range saturates at a higher light
+             */
+            static bool saturatesAbove(unsigned, unsigned);
+
+            /**
+             * Set the thresholds of the interrupt around a reading, and clear the pending interrupt
+             * @param channel0 The broadband channel of the reading, with the current range
+             */
+            void arm(uint32_t);
+
+            /**
+             * Configure the pin of the interrupt line. Throws an exception if it can't be used
+             */
+            void setupInterrupt();
+
+            /**
+             * Return if the interrupt line is asserted, i.e. if the light left the thresholds since
+             * they were set
+             * @return True if the interrupt line is asserted
+             */
+            bool interrupted();
+
+            /**
+             * Read raw data from the I2C sensor, both channels at once
+             * @param channel0 Data read in the first channel
+             * @param channel1 Data read in the second channel
+             */
+            void readRawData(uint32_t*, uint32_t*);
     };
 
 }
@@ -0,0 +1,186 @@
+/**
+ * @file TSL2561_lux.h
+ * @brief Stateless conversion of the raw TSL2561 channels to lux, specialized at compile time by
+ * package and integration time
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#ifndef H_TSL2561_LUX
+#define H_TSL2561_LUX
+
+#include <inttypes.h>
+#include <stddef.h>
+
+#define LUX_SCALE 14           // scale by 2^14
+#define RATIO_SCALE 9          // scale ratio by 2^9
+#define CH_SCALE 10            // scale channel values by 2^10
+#define CHSCALE_TINT0 0x7517   // 322/11 * 2^CH_SCALE
+#define CHSCALE_TINT1 0x0fe7   // 322/81 * 2^CH_SCALE
+
+// Number of segments of the lux approximation, each one being used up to its ratio
+#define TSL2561_SEGMENTS 8
+
+/**
+ * @namespace sensor
+ *
+ * Name space used to store every class and functions related to the sensors
+ */
+namespace sensor {
+
+    /**
+     * @brief Enum of the TSL2561 packages
+     */
+    enum tsl2561Package {
+        PACKAGE_T,  // T, FN and CL packages
+        PACKAGE_CS  // CS package
+    };
+
+    typedef enum tsl2561Package tsl2561Package;
+
+    /**
+     * @brief Enum of the TSL2561 integration times
+     */
+    enum tsl2561Timing {
+        TIMING_13MS,  // 13.7ms
+        TIMING_101MS, // 101ms
+        TIMING_402MS  // 402ms
+    };
+
+    typedef enum tsl2561Timing tsl2561Timing;
+
+    /**
+     * @brief Struct of a segment of the lux approximation : lux = channel0 * b - channel1 * m, used
+     * while the ratio channel1 / channel0 is below k
+     */
+    struct tsl2561Segment {
+        uint16_t k; // Ratio up to which the segment is used, * 2^RATIO_SCALE
+        uint16_t b; // Coefficient of the broadband channel, * 2^LUX_SCALE
+        uint16_t m; // Coefficient of the infrared channel, * 2^LUX_SCALE
+    };
+
+    /**
+     * @brief Coefficients of the lux approximation of each package
+     */
+    template<tsl2561Package P>
+    struct tsl2561Coefficients;
+
+    template<>
+    struct tsl2561Coefficients<PACKAGE_T> {
+        static constexpr tsl2561Segment segments[TSL2561_SEGMENTS] = {
+            { 0x0040, 0x01f2, 0x01be },  // 0.125, 0.0304, 0.0272
+            { 0x0080, 0x0214, 0x02d1 },  // 0.250, 0.0325, 0.0440
+            { 0x00c0, 0x023f, 0x037b },  // 0.375, 0.0351, 0.0544
+            { 0x0100, 0x0270, 0x03fe },  // 0.50, 0.0381, 0.0624
+            { 0x0138, 0x016f, 0x01fc },  // 0.61, 0.0224, 0.0310
+            { 0x019a, 0x00d2, 0x00fb },  // 0.80, 0.0128, 0.0153
+            { 0x029a, 0x0018, 0x0012 },  // 1.3, 0.00146, 0.00112
+            { 0xffff, 0x0000, 0x0000 }   // above 1.3, 0.000, 0.000
+        };
+    };
+
+    template<>
+    struct tsl2561Coefficients<PACKAGE_CS> {
+        static constexpr tsl2561Segment segments[TSL2561_SEGMENTS] = {
+            { 0x0043, 0x0204, 0x01ad },  // 0.130, 0.0315, 0.0262
+            { 0x0085, 0x0228, 0x02c1 },  // 0.260, 0.0337, 0.0430
+            { 0x00c8, 0x0253, 0x0363 },  // 0.390, 0.0363, 0.0529
+            { 0x010a, 0x0282, 0x03df },  // 0.520, 0.0392, 0.0605
+            { 0x014d, 0x0177, 0x01dd },  // 0.65, 0.0229, 0.0291
+            { 0x019a, 0x0101, 0x0127 },  // 0.80, 0.0157, 0.0180
+            { 0x029a, 0x0037, 0x002b },  // 1.3, 0.00338, 0.00260
+            { 0xffff, 0x0000, 0x0000 }   // above 1.3, 0.000, 0.000
+        };
+    };
+
+    /**
+     * @brief Scale of the channels of each integration time, to the 402ms integration
+     */
+    template<tsl2561Timing T>
+    struct tsl2561Scale {
+        static constexpr uint32_t value = (T == TIMING_13MS ? CHSCALE_TINT0 : T == TIMING_101MS ? CHSCALE_TINT1 : (1 << CH_SCALE));
+    };
+
+    /**
+     * @class TSL2561_lux
+     * @brief Stateless conversion of the raw TSL2561 channels to lux, following the integer algorithm
+     * of the datasheet
+     *
+     *  The conversion is specialized for each package and integration time, so the coefficients are
+     *  constants, and the segment is found without any branch. The runtime versions dispatch to the
+     *  specialized ones
+     */
+    class TSL2561_lux {
+
+        public:
+            /**
+             * @brief Convert raw channels to lux
+             * @param  channel0 The broadband channel
+             * @param  channel1 The infrared channel
+             * @param  gain     The gain, 0 for 1x or 1 for 16x
+             * @return          The lux value
+             */
+            template<tsl2561Package P, tsl2561Timing T>
+            static uint32_t lux(uint32_t channel0, uint32_t channel1, uint16_t gain) {
+                // Scale the channels to 16x and 402ms
+                const uint32_t chScale = tsl2561Scale<T>::value << (gain ? 0 : 4);
+
+                channel0 = (channel0 * chScale) >> CH_SCALE;
+                channel1 = (channel1 * chScale) >> CH_SCALE;
+
+                // Rounded ratio of the channels
+                uint32_t ratio = channel0 ? (((channel1 << (RATIO_SCALE + 1)) / channel0) + 1) >> 1 : 0;
+
+                // The segments are sorted, so the segment is the number of ratios exceeded
+                unsigned segment = 0;
+
+                for(unsigned i = 0; i < TSL2561_SEGMENTS - 1; i++)
+                    segment += (ratio > tsl2561Coefficients<P>::segments[i].k);
+
+                const uint32_t positive = channel0 * tsl2561Coefficients<P>::segments[segment].b;
+                const uint32_t negative = channel1 * tsl2561Coefficients<P>::segments[segment].m;
+
+                // Do not allow negative lux value, and strip off fractional portion
+                return positive > negative ? (positive - negative + (1 << (LUX_SCALE - 1))) >> LUX_SCALE : 0;
+            }
+
+            /**
+             * @brief Convert arrays of raw channels to lux
+             * @param count    The number of samples
+             * @param channel0 The broadband channels
+             * @param channel1 The infrared channels
+             * @param gain     The gain, 0 for 1x or 1 for 16x
+             * @param lux      The lux values computed
+             */
+            template<tsl2561Package P, tsl2561Timing T>
+            static void lux(size_t count, const uint32_t* channel0, const uint32_t* channel1, uint16_t gain, uint32_t* lux) {
+                for(size_t i = 0; i < count; i++)
+                    lux[i] = TSL2561_lux::lux<P, T>(channel0[i], channel1[i], gain);
+            }
+
+            /**
+             * @brief Convert raw channels to lux
+             * @param  package  The package of the sensor
+             * @param  timing   The integration time
+             * @param  gain     The gain, 0 for 1x or 1 for 16x
+             * @param  channel0 The broadband channel
+             * @param  channel1 The infrared channel
+             * @return          The lux value
+             */
+            static uint32_t compute(tsl2561Package, tsl2561Timing, uint16_t, uint32_t, uint32_t);
+
+            /**
+             * @brief Convert arrays of raw channels to lux
+             * @param package  The package of the sensor
+             * @param timing   The integration time
+             * @param gain     The gain, 0 for 1x or 1 for 16x
+             * @param count    The number of samples
+             * @param channel0 The broadband channels
+             * @param channel1 The infrared channels
+             * @param lux      The lux values computed
+             */
+            static void compute(tsl2561Package, tsl2561Timing, uint16_t, size_t, const uint32_t*, const uint32_t*, uint32_t*);
+    };
+}
+
+#endif // H_TSL2561_LUX
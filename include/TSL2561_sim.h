@@ -0,0 +1,69 @@
+/**
+ * @file TSL2561_sim.h
+ * @brief Simulated TSL2561 device, to be plugged on a simulated I2C bus
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#ifndef H_TSL2561_SIM
+#define H_TSL2561_SIM
+
+#include <chrono>
+#include <algorithm>
+
+#include "i2c_sim_transport.h"
+
+/**
+ * @namespace sensor
+ *
+ * Name space used to store every class and functions related to the sensors
+ */
+namespace sensor {
+
+    /**
+     * @class TSL2561_sim_device
+     * @brief Register map model of a TSL2561
+     *
+     *  Registers are accessed through the command byte (command bit, clear bit, register
+     *  address). Once powered up, the ADC channels hold the counts of the last complete
+     *  integration, computed from the simulated irradiance, the gain and the integration time
+     *  (13.7, 101 or 402 ms), and are zero until the first integration completes
+     */
+    class TSL2561_sim_device : public i2c_sim_device {
+
+        public:
+            /**
+             *  @brief Constructor
+             */
+            TSL2561_sim_device();
+
+            /**
+             *  @brief Destructor
+             */
+            virtual ~TSL2561_sim_device();
+
+            void read(uint8_t, uint8_t*, size_t);
+            void write(uint8_t, uint8_t);
+
+            /**
+             * @brief Set the simulated irradiance, as counts with a 1x gain and a 402 ms integration
+             * @param broadband Counts of channel 0 (visible and infrared)
+             * @param infrared  Counts of channel 1 (infrared only)
+             */
+            void setIrradiance(uint32_t, uint32_t);
+
+        private:
+            /**
+             * @brief Update the ADC channels, if an integration has completed
+             */
+            void update();
+
+            uint8_t registers[16]; // Register map
+            uint32_t broadband;    // Simulated channel 0 counts, at 1x and 402 ms
+            uint32_t infrared;     // Simulated channel 1 counts, at 1x and 402 ms
+
+            std::chrono::steady_clock::time_point integrationStart; // Start of the integrations
+    };
+}
+
+#endif // H_TSL2561_SIM
@@ -0,0 +1,151 @@
+/**
+ * @file gpio_backend.h
+ * @brief Interface of the backends used to access the GPIO pins
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#ifndef H_GPIO_BACKEND
+#define H_GPIO_BACKEND
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "sensor.h"
+#include "format.h"
+
+#ifndef GPIO_CHIP_FILE
+    // Default GPIO chip, used when no backend is specified. Should be setted from node-gyp
+    #define GPIO_CHIP_FILE "/dev/gpiochip0"
+#endif
+
+/**
+ * @namespace sensor
+ *
+ * Name space used to store every class and functions related to the sensors
+ */
+namespace sensor {
+
+    /**
+     * @brief Struct of an edge of a pin
+     */
+    struct gpioEdge {
+        uint64_t timestamp; // Time of the edge (ns)
+        bool rising;        // If the pin went high
+    };
+
+    /**
+     * @class gpio_backend
+     * @brief Interface of the backends used to access the GPIO pins
+     *
+     *  Pins use the wiringPi numbering, whatever the backend. A backend is shared by every
+     *  sensor using it, and must be thread safe. Backends are reference counted, shared through
+     *  a registry keyed by their name, and should be obtained with acquire()
+     */
+    class gpio_backend {
+
+        public:
+            /**
+             * @brief Destructor
+             */
+            virtual ~gpio_backend() {};
+
+            /**
+             * @brief Use a pin as an input, releasing it. Throws an exception on failure
+             * @param pin    The pin
+             * @param pullUp If the pull-up resistor of the pin should be enabled
+             */
+            virtual void setInput(unsigned, bool) = 0;
+
+            /**
+             * @brief Use a pin as an output. Throws an exception on failure
+             * @param pin   The pin
+             * @param value The value to drive the pin to
+             */
+            virtual void setOutput(unsigned, bool) = 0;
+
+            /**
+             * @brief Read the value of a pin. Throws an exception on failure
+             * @param  pin The pin
+             * @return     The value of the pin
+             */
+            virtual bool read(unsigned) = 0;
+
+            /**
+             * @brief Send a start signal, by driving a pin low then releasing it, and measure the
+             * high pulses answered. Throws an exception on failure
+             * @param  pin      The pin
+             * @param  startLow How long to drive the pin low (us)
+             * @param  widths   Where to store the width of each high pulse (us)
+             * @param  max      Maximum number of pulses to measure
+             * @param  timeout  Maximum duration of the answer (us)
+             * @return          The number of pulses measured
+             */
+            virtual unsigned capturePulses(unsigned, unsigned, unsigned*, unsigned, unsigned) = 0;
+
+            /**
+             * @brief Get the specified backend, creating it if needed. A backend is either the path
+             * of a GPIO chip (e.g. /dev/gpiochip0), 'wiringpi', 'sim[:<jitter in us>]' for simulated
+             * pins, or empty for the default chip (sharing the backend of its path), falling back to
+             * wiringPi if the chip can't be used. Every call should be matched by a call to release().
+             * Throws an exception if the backend can't be created
+             * @param  name The backend
+             * @return      The backend
+             */
+            static gpio_backend* acquire(const std::string&);
+
+            /**
+             * @brief Release a backend previously acquired. The backend is destroyed when the last
+             * reference is released
+             * @param backend The backend
+             */
+            static void release(gpio_backend*);
+
+        protected:
+            /**
+             * @brief Return the BCM number of a pin, i.e. its line on the GPIO chip
+             * @param  pin The pin, in the wiringPi numbering
+             * @return     The BCM number of the pin. Throws an exception if there is none
+             */
+            static unsigned pinToLine(unsigned);
+
+            /**
+             * @brief Measure the high pulses of a sequence of edges
+             * @param  edges  The edges
+             * @param  count  The number of edges
+             * @param  widths Where to store the width of each high pulse (us)
+             * @param  max    Maximum number of pulses to measure
+             * @return        The number of pulses measured
+             */
+            static unsigned pulseWidths(const gpioEdge*, size_t, unsigned*, unsigned);
+
+        private:
+            /**
+             * @brief Create the specified backend. Throws an exception on failure
+             * @param  name The backend
+             * @return      The backend created
+             */
+            static gpio_backend* create(const std::string&);
+
+            /**
+             * @brief Get a backend from the registry, creating it if needed, and add a reference to it.
+             * The registry lock must be held. Throws an exception if the backend can't be created
+             * @param  name The backend, not empty
+             * @return      The backend
+             */
+            static gpio_backend* reference(const std::string&);
+
+            std::string name;    // Name of the backend in the registry
+            unsigned references; // Number of sensors using the backend
+
+            static std::map<std::string, gpio_backend*> backends; // Registry of the backends
+            static std::mutex registryLock;                       // Protects 'backends'
+    };
+}
+
+#endif // H_GPIO_BACKEND
@@ -0,0 +1,151 @@
+/**
+ * @file gpio_chardev.h
+ * @brief GPIO lines requested through the Linux GPIO character device (e.g. /dev/gpiochip0), and
+ * the GPIO backend using them
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#ifndef H_GPIO_CHARDEV
+#define H_GPIO_CHARDEV
+
+#include <unistd.h>
+#include <linux/gpio.h>
+#include <sys/ioctl.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <inttypes.h>
+#include <string.h>
+#include <errno.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <string>
+
+#include "gpio_backend.h"
+
+// Consumer name of the requested lines, and size of the kernel event buffer (edges)
+#define GPIO_CONSUMER "raspi-sensors"
+#define GPIO_EVENT_BUFFER 128
+
+/**
+ * @namespace sensor
+ *
+ * Name space used to store every class and functions related to the sensors
+ */
+namespace sensor {
+
+    /**
+     * @class gpio_chardev
+     * @brief Line of a GPIO chip, requested through the GPIO character device (v2 uAPI)
+     *
+     *  The line is requested once, when the object is created, and kept as long as it lives. When
+     *  edge detection is enabled, the kernel timestamps each edge from its interrupt handler and
+     *  queues it until read, so no edge is lost or mistimed while the reading thread is not
+     *  scheduled
+     */
+    class gpio_chardev {
+
+        public:
+            /**
+             *  @brief Constructor. Request the line as an input. Throws an exception if the chip
+             *  can't be opened or doesn't support the v2 uAPI, or if the line is busy
+             *  @param path   Path of the chip file
+             *  @param offset Offset of the line on the chip
+             */
+            gpio_chardev(const std::string&, unsigned);
+
+            /**
+             *  @brief Destructor. Release the line
+             */
+            ~gpio_chardev();
+
+            /**
+             * @brief Use the line as an output. Throws an exception on failure
+             * @param value The value to drive the line to
+             */
+            void setOutput(bool);
+
+            /**
+             * @brief Use the line as an input, releasing it. Throws an exception on failure
+             * @param edges  If the edges of the line should be detected. When disabled, every edge not
+             *               read yet is discarded
+             * @param pullUp If the pull-up resistor of the line should be enabled
+             */
+            void setInput(bool, bool = false);
+
+            /**
+             * @brief Read the value of the line. Throws an exception on failure
+             * @return The value of the line
+             */
+            bool getValue();
+
+            /**
+             * @brief Read the edges detected, timestamped with the monotonic clock, waiting for them until enough are read or until the
+             * timeout expires. Throws an exception on failure
+             * @param  edges   Where to store the edges
+             * @param  max     Maximum number of edges to read
+             * @param  timeout Maximum time to wait for the edges (us)
+             * @return         The number of edges read
+             */
+            size_t readEdges(gpioEdge*, size_t, unsigned);
+
+        private:
+            /**
+             * @brief Apply a line configuration. Throws an exception on failure
+             * @param flags  Flags of the line
+             * @param output If the value of the line should be set
+             * @param value  The value of the line, if set
+             */
+            void configure(uint64_t, bool, bool);
+
+            std::string path; // Path of the chip file
+            unsigned offset;  // Offset of the line on the chip
+            int fd;           // File descriptor of the requested line
+    };
+
+    /**
+     * @class gpio_chardev_backend
+     * @brief GPIO backend using the Linux GPIO character device
+     *
+     *  The line of each pin is requested on first use, and kept as long as the backend lives.
+     *  Start signals are answered with edges timestamped by the kernel, while the calling
+     *  thread sleeps
+     */
+    class gpio_chardev_backend : public gpio_backend {
+
+        public:
+            /**
+             *  @brief Constructor. Throws an exception if the chip can't be opened
+             *  @param path Path of the chip file
+             */
+            gpio_chardev_backend(const std::string&);
+
+            /**
+             *  @brief Destructor. Release every line
+             */
+            virtual ~gpio_chardev_backend();
+
+            void setInput(unsigned, bool);
+            void setOutput(unsigned, bool);
+            bool read(unsigned);
+            unsigned capturePulses(unsigned, unsigned, unsigned*, unsigned, unsigned);
+
+        private:
+            /**
+             * @brief Return the line of a pin, requesting it if needed. Throws an exception on failure
+             * @param  pin The pin
+             * @return     The line of the pin
+             */
+            gpio_chardev* getLine(unsigned);
+
+            std::string path;                        // Path of the chip file
+            std::map<unsigned, gpio_chardev*> lines; // Line of each pin used
+            std::mutex linesLock;                    // Protects 'lines'
+    };
+}
+
+#endif // H_GPIO_CHARDEV
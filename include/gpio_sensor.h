@@ -8,10 +8,10 @@
 #ifndef H_GPIO_SENSOR
 #define H_GPIO_SENSOR
 
-#include <wiringPi.h>
-#include <sys/time.h>
+#include <mutex>
 
 #include "sensor.h"
+#include "gpio_backend.h"
 
 /**
  * @namespace sensor
@@ -25,18 +25,20 @@ namespace sensor {
      * @brief Base class for all the GPIO sensors
      *
      *  Base class for all the GPIO sensors. The class extends the default sensor function
-     *  and adds the handling of the pin number, and default function to easily handle
-     *  GPIO features (waiting for a state change, etc...)
+     *  and adds the handling of the pin number, and of the GPIO backend used to access it,
+     *  which is acquired on the first fetch
      */
     class gpio_sensor : public sensor {
 
         public:
             /**
              *  @brief Constructor
-             *  @param pin  Value of which pin to read data on
-             *  @param name Name of the sensor
+             *  @param pin     Value of which pin to read data on
+             *  @param name    Name of the sensor
+             *  @param backend GPIO backend of the pin (see gpio_backend::acquire()), empty for the
+             *                 default one
              */
-            gpio_sensor(unsigned, std::string);
+            gpio_sensor(unsigned, std::string, const std::string& = "");
 
             /**
              *  @brief Destructor
@@ -55,28 +57,14 @@ namespace sensor {
              */
             void prepare();
 
-            /**
-             * Get the time of change 
-             * @param  laststate Last state of the value
-             * @return           The time between the state change
-             */
-            int getTime(uint8_t*);
-
-            /**
-             * Get the time difference between two interval of time
-             * @param  x The first interval
-             * @param  y The second interval
-             * @return   The difference in ms
-             */
-            double timeDiff(struct timeval, struct timeval);
-
-            unsigned pin; // Pin number
+            unsigned pin;          // Pin number
+            gpio_backend* backend; // Backend of the pin, once acquired
 
         private:
-            static bool isGPIOInitialized; // Used to know if wiringPi is initialized
+            std::string backendName; // Name of the backend of the pin
+            std::mutex backendLock;  // Protects the acquisition of 'backend'
     };
 
 }
 
 #endif // H_GPIO_SENSOR
-
@@ -0,0 +1,99 @@
+/**
+ * @file gpio_sim_backend.h
+ * @brief Simulated GPIO backend, holding models of the supported devices. Used to run and
+ * benchmark the GPIO drivers without any real pin
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#ifndef H_GPIO_SIM_BACKEND
+#define H_GPIO_SIM_BACKEND
+
+#include <inttypes.h>
+#include <stddef.h>
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "gpio_backend.h"
+
+/**
+ * @namespace sensor
+ *
+ * Name space used to store every class and functions related to the sensors
+ */
+namespace sensor {
+
+    /**
+     * @class gpio_sim_device
+     * @brief Interface of the simulated devices, wired to a simulated pin
+     */
+    class gpio_sim_device {
+
+        public:
+            /**
+             * @brief Destructor
+             */
+            virtual ~gpio_sim_device() {};
+
+            /**
+             * @brief Return the level of the pin driven by the device, or pulled up if the device
+             * doesn't drive it
+             * @return The level of the pin
+             */
+            virtual bool level() = 0;
+
+            /**
+             * @brief Answer a start signal. Ignored by default
+             * @param  startLow How long the pin was driven low (us)
+             * @param  edges    Where to store the edges of the answer, timestamped from the release
+             *                  of the pin (ns)
+             * @param  max      Maximum number of edges to store
+             * @return          The number of edges stored
+             */
+            virtual size_t answer(unsigned, gpioEdge*, size_t) { return 0; };
+    };
+
+    /**
+     * @class gpio_sim_backend
+     * @brief Simulated GPIO backend
+     *
+     *  Each pin may be wired to a device model, which plays its waveforms : reading a pin returns
+     *  the level driven by its device (or by the backend, if the pin is an output), and start
+     *  signals get the edges answered by the device, instantly. Pins without any device are
+     *  pulled up, and never answer
+     */
+    class gpio_sim_backend : public gpio_backend {
+
+        public:
+            /**
+             *  @brief Constructor
+             */
+            gpio_sim_backend();
+
+            /**
+             *  @brief Destructor. Delete every device wired
+             */
+            virtual ~gpio_sim_backend();
+
+            /**
+             * @brief Wire a device to a pin. The backend takes the ownership of the device
+             * @param pin    The pin
+             * @param device The device
+             */
+            void attach(unsigned, gpio_sim_device*);
+
+            void setInput(unsigned, bool);
+            void setOutput(unsigned, bool);
+            bool read(unsigned);
+            unsigned capturePulses(unsigned, unsigned, unsigned*, unsigned, unsigned);
+
+        private:
+            std::map<unsigned, gpio_sim_device*> devices; // Device wired to each pin
+            std::map<unsigned, bool> outputs;             // Value of each pin used as an output
+            std::mutex lock;                              // Protects the devices and the pins
+    };
+}
+
+#endif // H_GPIO_SIM_BACKEND
@@ -0,0 +1,71 @@
+/**
+ * @file gpio_wiringpi_backend.h
+ * @brief GPIO backend using wiringPi
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#ifndef H_GPIO_WIRINGPI_BACKEND
+#define H_GPIO_WIRINGPI_BACKEND
+
+#include <wiringPi.h>
+#include <sys/time.h>
+
+#include "gpio_backend.h"
+
+/**
+ * @namespace sensor
+ *
+ * Name space used to store every class and functions related to the sensors
+ */
+namespace sensor {
+
+    /**
+     * @class gpio_wiringpi_backend
+     * @brief GPIO backend using wiringPi
+     *
+     *  The pins are accessed through the registers of the GPIO controller. Start signals are
+     *  answered by polling the pin, which keeps a core busy for the whole answer, and may
+     *  mistime a pulse if the thread is preempted
+     */
+    class gpio_wiringpi_backend : public gpio_backend {
+
+        public:
+            /**
+             *  @brief Constructor. Initialize wiringPi, if not already initialized. Throws an
+             *  exception on failure
+             */
+            gpio_wiringpi_backend();
+
+            /**
+             *  @brief Destructor
+             */
+            virtual ~gpio_wiringpi_backend();
+
+            void setInput(unsigned, bool);
+            void setOutput(unsigned, bool);
+            bool read(unsigned);
+            unsigned capturePulses(unsigned, unsigned, unsigned*, unsigned, unsigned);
+
+        private:
+            /**
+             * Get the time of change 
+             * @param  pin       The pin
+             * @param  laststate Last state of the value
+             * @return           The time between the state change
+             */
+            int getTime(unsigned, uint8_t*);
+
+            /**
+             * Get the time difference between two interval of time
+             * @param  x The first interval
+             * @param  y The second interval
+             * @return   The difference in us
+             */
+            double timeDiff(struct timeval, struct timeval);
+
+            static bool isGPIOInitialized; // Used to know if wiringPi is initialized
+    };
+}
+
+#endif // H_GPIO_WIRINGPI_BACKEND
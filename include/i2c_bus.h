@@ -0,0 +1,255 @@
+/**
+ * @file i2c_bus.h
+ * @brief Shared handle on an I2C bus. Every I2C sensor on the same bus uses the same handle
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#ifndef H_I2C_BUS
+#define H_I2C_BUS
+
+#include <inttypes.h>
+
+#include <map>
+#include <set>
+#include <tuple>
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include <string>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <condition_variable>
+
+#include "sensor.h"
+#include "i2c_transaction.h"
+#include "i2c_transport.h"
+
+// Number of buckets of the latency histograms. Bucket i counts the latencies in [2^i, 2^(i+1)) us,
+// the last one counts every latency above
+#define I2C_LATENCY_BUCKETS 24
+
+// Circuit breaker of the devices : number of consecutive failed transactions before considering a
+// device as failing, and minimum and maximum delay between two probes of a failing device (ms)
+#define I2C_FAILURES_THRESHOLD 3
+#define I2C_BACKOFF_MIN 1000
+#define I2C_BACKOFF_MAX 300000
+
+/**
+ * @namespace sensor
+ *
+ * Name space used to store every class and functions related to the sensors
+ */
+namespace sensor {
+
+    /**
+     * @brief Struct of a transaction waiting to be performed by the bus executor
+     */
+    struct i2cPendingTransaction {
+        i2c_transaction* transaction;                     // Transaction to perform
+        std::promise<void> done;                          // Completed when the transaction is performed
+        std::chrono::steady_clock::time_point submission; // Time of the submission
+    };
+
+    /**
+     * @brief Enum of the health states of a device
+     */
+    enum i2cDeviceState {
+        DEVICE_CLOSED,    // Healthy, every transaction is performed
+        DEVICE_OPEN,      // Failing, transactions are rejected until the next probe
+        DEVICE_HALF_OPEN  // Failing, a transaction is performed as a probe
+    };
+
+    typedef enum i2cDeviceState i2cDeviceState;
+
+    /**
+     * @brief Struct of the health of a device, used as a circuit breaker
+     */
+    struct i2cDeviceHealth {
+        i2cDeviceState state = DEVICE_CLOSED;
+        unsigned failures = 0;                           // Consecutive failed transactions
+        std::chrono::milliseconds backoff{0};            // Delay between two probes
+        std::chrono::steady_clock::time_point nextProbe; // Time of the next probe
+    };
+
+    /**
+     * @brief Struct of the statistics of a bus, or of a device
+     */
+    struct i2cStats {
+        uint64_t transactions = 0;              // Transactions submitted
+        uint64_t bytes = 0;                     // Bytes read or written
+        uint64_t errors = 0;                    // Transactions failed
+        uint64_t rejected = 0;                  // Transactions rejected because the device is failing
+        std::map<int, uint64_t> errorsByErrno;  // Transactions failed, by errno (0 if unknown)
+        std::chrono::nanoseconds busyTime{0};   // Time spent holding the bus
+        std::chrono::nanoseconds waitTime{0};   // Time spent waiting for the bus
+        uint64_t latency[I2C_LATENCY_BUCKETS] = {}; // Histogram of the latencies, from the submission to the completion
+    };
+
+    /**
+     * @brief Struct of a device of a bus
+     */
+    struct i2cDevice {
+        i2cDeviceHealth health; // Health of the device
+        i2cStats stats;         // Statistics of the device
+    };
+
+    /**
+     * @brief Struct of the statistics of a device, as returned by i2c_bus::getAllStats()
+     */
+    struct i2cDeviceStats {
+        int mux;              // Address of the multiplexer of the device, or -1
+        int channel;          // Channel of the device on its multiplexer, or -1
+        uint16_t address;     // Address of the device
+        i2cDeviceState state; // Health of the device
+        i2cStats stats;       // Statistics of the device
+    };
+
+    /**
+     * @brief Struct of the statistics of a bus, as returned by i2c_bus::getAllStats()
+     */
+    struct i2cBusStats {
+        std::string path;                  // Path of the bus
+        double utilization;                // Utilization of the bus
+        i2cStats stats;                    // Statistics of the bus
+        std::list<i2cDeviceStats> devices; // Statistics of each device
+    };
+
+    /**
+     * @class i2c_bus
+     * @brief Reference counted executor of an I2C bus
+     *
+     *  Each bus has its own worker thread, which is the only one to use the bus transport. Sensors
+     *  submit transactions, which are performed back to back, grouped by slave address, and
+     *  completed through futures. Each device has a circuit breaker : after several consecutive
+     *  failures, its transactions are rejected without using the bus, except for one probe per
+     *  backoff period, which doubles after each failed probe. The bus lives as long as any sensor
+     *  references it. Handles are
+     *  shared through a registry keyed by the bus path, and should be obtained with acquire()
+     */
+    class i2c_bus {
+
+        public:
+            /**
+             * @brief Get the handle of the specified bus, creating it if needed. Every call
+             * should be matched by a call to release()
+             * @param  path Path of the bus file (e.g. /dev/i2c-1)
+             * @return      The bus handle
+             */
+            static i2c_bus* acquire(const std::string&);
+
+            /**
+             * @brief Release a handle previously acquired. The bus is closed when the
+             * last reference is released
+             * @param bus The bus handle
+             */
+            static void release(i2c_bus*);
+
+            /**
+             * @brief Return the path of the bus file
+             * @return The path of the bus file
+             */
+            const std::string& getPath();
+
+            /**
+             * @brief Queue a transaction to be performed by the bus executor. The transaction
+             * should stay valid until the returned future is ready
+             * @param  transaction The transaction to perform
+             * @return             The future completed when the transaction is performed, holding
+             *                     the exception if any error occured
+             */
+            std::future<void> submit(i2c_transaction&);
+
+            /**
+             * @brief Queue a transaction and wait for it to be performed. Throws an exception if any
+             * error occures
+             * @param transaction The transaction to perform
+             */
+            void execute(i2c_transaction&);
+
+            /**
+             * @brief Declare a multiplexer of the bus. Its control byte is unknown until written,
+             * so it is disabled as soon as a channel of another multiplexer is selected, even if
+             * none of its own channels was selected yet
+             * @param mux The address of the multiplexer
+             */
+            void addMux(int);
+
+            /**
+             * @brief Return the utilization of the bus, i.e. the fraction of time spent performing
+             * transactions since the creation of the bus
+             * @return The utilization of the bus, between 0 and 1
+             */
+            double getUtilization();
+
+            /**
+             * @brief Return the statistics of every bus, and of their devices
+             * @return The statistics of every bus
+             */
+            static std::list<i2cBusStats> getAllStats();
+
+        private:
+            i2c_bus(const std::string&);
+            ~i2c_bus();
+
+            /**
+             * @brief Executor loop, run by the worker thread of the bus
+             */
+            void run();
+
+            /**
+             * @brief Select the multiplexer channel of the device of a transaction, if needed. The
+             * control byte of a multiplexer is only written when the channel changes, and the other
+             * multiplexers are disabled. Throws an exception on failure
+             * @param transaction The transaction to route
+             */
+            void route(i2c_transaction&);
+
+            /**
+             * @brief Route a transaction and perform its operations, in order. Throws an exception on failure
+             * @param transaction The transaction to send
+             */
+            void send(i2c_transaction&);
+
+            /**
+             * @brief Perform all the operations of a transaction, unless its device is failing and
+             * not due for a probe, and update the health and the statistics of the device (if the
+             * transaction is accounted). Throws an exception on failure
+             * @param pending The transaction to perform
+             */
+            void perform(i2cPendingTransaction&);
+
+            /**
+             * @brief Account a transaction in statistics. The statistics lock must be held
+             * @param stats    The statistics to update
+             * @param pending  The transaction
+             * @param start    When the transaction was started
+             * @param error    The errno of the failure, 0 if unknown, or -1 if successful
+             * @param rejected If the transaction was rejected
+             */
+            void account(i2cStats&, i2cPendingTransaction&, std::chrono::steady_clock::time_point, int, bool);
+
+            std::string path;         // Path of the bus file
+            i2c_transport* transport; // Transport used to talk to the bus
+            unsigned references;      // Number of sensors using the bus
+            std::map<int, int> muxControls; // Control byte of each multiplexer, or -1 if unknown
+            std::map<std::tuple<int, int, int>, i2cDevice> devices; // Devices of the bus, by route
+            i2cStats stats;                                         // Statistics of the bus
+            std::mutex statsLock;                                   // Protects 'devices' and 'stats'
+
+            std::list<i2cPendingTransaction> queue;  // Transactions waiting to be performed
+            std::set<int> muxes;                     // Multiplexers declared, not yet in 'muxControls'
+            std::mutex queueLock;                    // Protects 'queue', 'muxes' and 'stopping'
+            std::condition_variable queueCondition;  // Signaled when 'queue' or 'stopping' changes
+            bool stopping;                           // If the worker should stop
+            std::thread worker;                      // Worker performing the transactions
+
+            std::chrono::steady_clock::time_point creation; // Creation of the bus
+
+            static std::map<std::string, i2c_bus*> buses; // Registry of the opened buses
+            static std::mutex registryLock;               // Protects 'buses'
+    };
+}
+
+#endif // H_I2C_BUS
@@ -0,0 +1,104 @@
+/**
+ * @file i2c_dev_transport.h
+ * @brief I2C transport using the Linux i2c-dev interface (e.g. /dev/i2c-1)
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#ifndef H_I2C_DEV_TRANSPORT
+#define H_I2C_DEV_TRANSPORT
+
+#include <unistd.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <sys/ioctl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <string.h>
+#include <errno.h>
+
+#include "i2c_transport.h"
+
+/**
+ * @namespace sensor
+ *
+ * Name space used to store every class and functions related to the sensors
+ */
+namespace sensor {
+
+    /**
+     * @brief Enum of the different ways of talking to the bus, from the fastest to the slowest
+     */
+    enum i2cBackend {
+        BACKEND_RDWR,       // Combined transactions using I2C_RDWR, for plain I2C adapters
+        BACKEND_SMBUS,      // SMBus transfers using I2C_SMBUS, for SMBus only adapters
+        BACKEND_READ_WRITE  // Raw read() and write() on the bus file, if nothing else is known
+    };
+
+    typedef enum i2cBackend i2cBackend;
+
+    /**
+     * @class i2c_dev_transport
+     * @brief I2C transport using the Linux i2c-dev interface
+     *
+     *  The bus file is opened once, on first use, and kept open as long as the transport
+     *  lives. The currently selected slave address is remembered so that I2C_SLAVE is only
+     *  issued when the address changes. The adapter functionalities are queried when the bus
+     *  is opened, and the fastest backend supported is used for every transfer
+     */
+    class i2c_dev_transport : public i2c_transport {
+
+        public:
+            /**
+             *  @brief Constructor
+             *  @param path Path of the bus file
+             */
+            i2c_dev_transport(const std::string&);
+
+            /**
+             *  @brief Destructor
+             */
+            virtual ~i2c_dev_transport();
+
+            void readBlock(uint16_t, uint8_t, uint8_t*, size_t);
+            void writeByte(uint16_t, uint8_t, uint8_t);
+            void sendByte(uint16_t, uint8_t);
+
+        private:
+            /**
+             * @brief Return the file descriptor of the bus, opening it if needed. Throws an exception
+             * if the bus can't be opened
+             * @return The bus file descriptor
+             */
+            int getFd();
+
+            /**
+             * @brief Select the slave device to talk to. I2C_SLAVE is only issued if the
+             * address differs from the currently selected one. Throws an exception on failure
+             * @param address Address of the device
+             */
+            void selectDevice(uint16_t);
+
+            /**
+             * @brief Return the backend used to talk to the adapter, opening the bus if needed
+             * @return The backend used
+             */
+            i2cBackend getBackend();
+
+            /**
+             * @brief Perform an SMBus transfer on the selected device
+             * @return The ioctl result
+             */
+            int smbusAccess(char, uint8_t, int, union i2c_smbus_data*);
+
+            std::string path;     // Path of the bus file
+            int fd;               // File descriptor of the bus, or -1
+            int selectedAddress;  // Currently selected slave address, or -1
+            unsigned long funcs;  // Functionalities of the adapter, from I2C_FUNCS
+            i2cBackend backend;   // Backend used to talk to the adapter
+    };
+}
+
+#endif // H_I2C_DEV_TRANSPORT
@@ -0,0 +1,121 @@
+/**
+ * @file i2c_scan.h
+ * @brief Discovery of the known I2C sensors of a bus
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#ifndef H_I2C_SCAN
+#define H_I2C_SCAN
+
+#include <inttypes.h>
+
+#include <list>
+#include <string>
+
+#include "sensor.h"
+
+#ifndef I2C_SCAN_CACHE_DIR
+    // Directory of the scan cache files
+    #define I2C_SCAN_CACHE_DIR "/tmp"
+#endif
+
+// Default maximum age of a scan cache before probing the bus again (s)
+#define I2C_SCAN_CACHE_MAX_AGE 86400
+
+/**
+ * @namespace sensor
+ *
+ * Name space used to store every class and functions related to the sensors
+ */
+namespace sensor {
+
+    /**
+     * @brief Struct of a sensor found on a bus
+     */
+    struct i2cScanDevice {
+        uint16_t address;    // Address of the sensor
+        std::string type;    // Type of the sensor (e.g. BMP180)
+        std::string package; // Package of TSL2561 sensors ("T" for T, FN and CL, or "CS"), empty otherwise
+    };
+
+    /**
+     * @brief Struct of the result of a scan, or of its error
+     */
+    struct i2cScanResult {
+        std::list<i2cScanDevice> devices; // Sensors found, if no error
+        bool failed = false;              // If an error occured
+        sensorException error;            // Error, if any occured
+    };
+
+    /**
+     * @class i2c_scanner
+     * @brief Discovery of the known I2C sensors of a bus
+     *
+     *  Every address a known sensor may use is probed at once through the bus executor, which
+     *  performs the probes back to back, and the sensors are identified by their ID register. The sensors
+     *  found on an i2c-dev bus are cached in a file, reused until it is too old
+     */
+    class i2c_scanner {
+
+        public:
+            /**
+             * @brief Return the known sensors of a bus, from its cache if recent enough or by
+             * probing it. Throws an exception on failure
+             * @param  path   The bus, or an empty string for the default one
+             * @param  maxAge Maximum age of the cache (s), 0 to always probe the bus
+             * @return        The sensors found, by address
+             */
+            static std::list<i2cScanDevice> scan(const std::string&, unsigned = I2C_SCAN_CACHE_MAX_AGE);
+
+            /**
+             * @brief Return the known sensors of a bus, or the error if any occured
+             * @param  path   The bus, or an empty string for the default one
+             * @param  maxAge Maximum age of the cache (s), 0 to always probe the bus
+             * @return        The sensors found, or the error
+             */
+            static i2cScanResult scanOrError(const std::string&, unsigned = I2C_SCAN_CACHE_MAX_AGE);
+
+        private:
+            /**
+             * @brief Probe the addresses of the known sensors on a bus, and identify the devices
+             * responding
+             * @param  path The bus
+             * @return      The sensors found, by address
+             */
+            static std::list<i2cScanDevice> probe(const std::string&);
+
+            /**
+             * @brief Identify a device from its address and its ID register
+             * @param id     The value of the ID register : 0xD0 at 0x77, or 0xA read with the
+             *               TSL2561 command bit at the other addresses
+             * @param device The device, whose type and package are set. The type stays empty if unknown
+             */
+            static void identify(uint8_t, i2cScanDevice&);
+
+            /**
+             * @brief Return the cache file of a bus
+             * @param  path The bus
+             * @return      The path of the cache file, or an empty string if the bus is not cached
+             */
+            static std::string cacheFile(const std::string&);
+
+            /**
+             * @brief Load the cache of a bus, if recent enough
+             * @param  path    The bus
+             * @param  maxAge  Maximum age of the cache (s)
+             * @param  devices The list to fill with the cached sensors
+             * @return         True if the cache was loaded
+             */
+            static bool loadCache(const std::string&, unsigned, std::list<i2cScanDevice>&);
+
+            /**
+             * @brief Save the cache of a bus. Failures are ignored
+             * @param path    The bus
+             * @param devices The sensors found
+             */
+            static void saveCache(const std::string&, const std::list<i2cScanDevice>&);
+    };
+}
+
+#endif // H_I2C_SCAN
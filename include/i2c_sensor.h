@@ -9,6 +9,7 @@
 #define H_I2C_SENSOR
 
 #include <unistd.h>
+#include <linux/i2c.h>
 #include <linux/i2c-dev.h>
 #include <sys/ioctl.h>
 #include <sys/types.h>
@@ -19,6 +20,8 @@
 #include <errno.h>
 
 #include "sensor.h"
+#include "i2c_bus.h"
+#include "i2c_transaction.h"
 
 /**
  * @namespace sensor
@@ -38,8 +41,9 @@ namespace sensor {
              *  @brief Constructor
              *  @param address Address of the sensor
              *  @param name    Name of the sensor
+             *  @param options Options of the sensor (bus, multiplexer)
              */
-            i2c_sensor(uint16_t, std::string);
+            i2c_sensor(uint16_t, std::string, const sensorOptions&);
 
             /**
              * @brief Destructor
@@ -66,6 +70,15 @@ namespace sensor {
              * @return          The integer read
              */
             uint16_t readRegisterInt(uint16_t address);
+
+            /**
+             * Read consecutive registers, starting at the specified one. The register pointer write
+             * and the read are performed in a single combined transaction (repeated start)
+             * @param  uint16_t The register where to start reading
+             * @param  uint8_t* The buffer to read into
+             * @param  size_t   The number of bytes to read
+             */
+            void readRegisterBlock(uint16_t, uint8_t*, size_t);
             
             /**
              * Write a value in the specified register
@@ -75,26 +88,23 @@ namespace sensor {
             void writeRegister(uint16_t, uint16_t);
 
             /**
-             * Open the bus to read data from. If the opening failed, the filed
-             * descriptor is set to -1
-             * @return          The bus descriptor, or -1 on error 
-             */
-            void openBus();
-
-            /**
-             * Return the file descriptor of the bus, or -1
-             * @return The bus file descriptor
+             * Perform a transaction on the bus, and wait for its completion. The operations of
+             * the transaction are performed back to back
+             * @param i2c_transaction The transaction to perform
              */
-            int getBus();
+            void execute(i2c_transaction&);
 
             /**
-             * Close the bus
+             * Return the bus used by the sensor
+             * @return The bus handle
              */
-            void closeBus();
+            i2c_bus* getBus();
 
         private:
-            int i2c_fd;              // File descriptor of the bus
+            i2c_bus* bus;            // Shared handle on the bus
             uint16_t deviceAddress;  // Adress of the device
+            int mux;                 // Address of the multiplexer of the device, or -1
+            int channel;             // Channel of the device on its multiplexer, or -1
     };
 }
 
@@ -0,0 +1,110 @@
+/**
+ * @file i2c_sim_transport.h
+ * @brief Simulated I2C transport, holding models of the supported devices. Used to run
+ * and benchmark the drivers without any real bus
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#ifndef H_I2C_SIM_TRANSPORT
+#define H_I2C_SIM_TRANSPORT
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+
+#include <map>
+#include <chrono>
+#include <thread>
+
+#include "i2c_transport.h"
+
+/**
+ * @namespace sensor
+ *
+ * Name space used to store every class and functions related to the sensors
+ */
+namespace sensor {
+
+    /**
+     * @class i2c_sim_device
+     * @brief Interface of the simulated devices, plugged on a simulated bus
+     */
+    class i2c_sim_device {
+
+        public:
+            /**
+             * @brief Destructor
+             */
+            virtual ~i2c_sim_device() {};
+
+            /**
+             * @brief Read consecutive registers, starting at the specified one
+             * @param reg    The register (or command) where to start reading
+             * @param buffer The buffer to read into
+             * @param len    The number of bytes to read
+             */
+            virtual void read(uint8_t, uint8_t*, size_t) = 0;
+
+            /**
+             * @brief Write a byte in a register
+             * @param reg   The register (or command) where to write at
+             * @param value The value to write
+             */
+            virtual void write(uint8_t, uint8_t) = 0;
+
+            /**
+             * @brief Receive a single byte, without any register. Ignored by default
+             * @param value The value received
+             */
+            virtual void send(uint8_t) {};
+    };
+
+    /**
+     * @class i2c_sim_transport
+     * @brief Simulated I2C transport
+     *
+     *  The transport forwards every operation to the device model plugged at the requested
+     *  address, and fails like a real bus if there is none. If a bus clock is specified, each
+     *  operation takes the time it would take on the wire at this clock
+     */
+    class i2c_sim_transport : public i2c_transport {
+
+        public:
+            /**
+             *  @brief Constructor
+             *  @param clock The emulated bus clock in kHz (usually 100 or 400), or 0 to
+             *               perform every operation instantly
+             */
+            i2c_sim_transport(unsigned);
+
+            /**
+             *  @brief Destructor. Every device plugged is also deleted
+             */
+            virtual ~i2c_sim_transport();
+
+            /**
+             * @brief Plug a device on the bus. The transport takes the ownership of the device
+             * @param address Address of the device
+             * @param device  The device
+             */
+            void attach(uint16_t, i2c_sim_device*);
+
+            void readBlock(uint16_t, uint8_t, uint8_t*, size_t);
+            void writeByte(uint16_t, uint8_t, uint8_t);
+            void sendByte(uint16_t, uint8_t);
+
+        private:
+            /**
+             * @brief Wait for the time needed to transfer the specified number of bits
+             * @param bits The number of bits on the wire, including start and stop conditions
+             */
+            void transfer(size_t);
+
+            std::map<uint16_t, i2c_sim_device*> devices; // Devices plugged, by address
+            unsigned clock;                              // Emulated clock in kHz, or 0
+    };
+}
+
+#endif // H_I2C_SIM_TRANSPORT
@@ -0,0 +1,172 @@
+/**
+ * @file i2c_trace_transport.h
+ * @brief I2C transports recording the transactions of a bus to a trace file, and replaying
+ * them to the drivers
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#ifndef H_I2C_TRACE_TRANSPORT
+#define H_I2C_TRACE_TRANSPORT
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <string.h>
+#include <errno.h>
+
+#include <chrono>
+#include <thread>
+#include <string>
+#include <map>
+#include <deque>
+#include <algorithm>
+
+#include "i2c_transport.h"
+
+// Trace file format. The file starts with the magic, followed by the records. Each record is
+// a header, then the bytes read or written (or the errno, if the operation failed). Every field
+// is little endian
+#define I2C_TRACE_MAGIC "I2CTRC01"
+#define I2C_TRACE_HEADER_SIZE 14 // timestamp (8, in us of a monotonic clock), bus (1), address (2), register (1), flags (1), length (1)
+
+#define I2C_TRACE_READ  0x01     // The operation is a read
+#define I2C_TRACE_ERROR 0x02     // The operation failed
+#define I2C_TRACE_SEND  0x04     // The operation is a single byte sent, held by the register field
+
+/**
+ * @namespace sensor
+ *
+ * Name space used to store every class and functions related to the sensors
+ */
+namespace sensor {
+
+    /**
+     * @brief Struct of a recorded I2C operation
+     */
+    struct i2cTraceRecord {
+        uint64_t timestamp; // Time of the operation, in microseconds of the monotonic clock
+        uint8_t bus;        // Number of the bus (/dev/i2c-N), or 0xFF if unknown
+        uint16_t address;   // Address of the device
+        uint8_t reg;        // Register read or written
+        uint8_t flags;      // I2C_TRACE_READ, I2C_TRACE_ERROR, I2C_TRACE_SEND
+        uint8_t len;        // Number of bytes read or written
+        uint8_t data[255];  // Bytes read or written, or errno if the operation failed
+    };
+
+    /**
+     * @class i2c_record_transport
+     * @brief Transport recording every operation performed on another transport
+     *
+     *  Each operation, successful or not, is appended to the trace file with a single write.
+     *  The errors of the recorded transport are forwarded as is. Reads of more than 255 bytes
+     *  can't be recorded, and fail with a file error
+     */
+    class i2c_record_transport : public i2c_transport {
+
+        public:
+            /**
+             *  @brief Constructor
+             *  @param transport The transport to record. The ownership is taken
+             *  @param path      Path of the trace file, created if needed
+             *  @param bus       Number of the recorded bus, or 0xFF if unknown
+             */
+            i2c_record_transport(i2c_transport*, const std::string&, uint8_t);
+
+            /**
+             *  @brief Destructor
+             */
+            virtual ~i2c_record_transport();
+
+            void readBlock(uint16_t, uint8_t, uint8_t*, size_t);
+            void writeByte(uint16_t, uint8_t, uint8_t);
+            void sendByte(uint16_t, uint8_t);
+
+        private:
+            /**
+             * @brief Append a record to the trace file
+             */
+            void record(uint16_t, uint8_t, uint8_t, const uint8_t*, size_t);
+
+            i2c_transport* transport; // Recorded transport
+            std::string path;         // Path of the trace file
+            uint8_t bus;              // Number of the recorded bus
+            int fd;                   // File descriptor of the trace file, or -1
+    };
+
+    /**
+     * @class i2c_replay_transport
+     * @brief Transport replaying a trace file
+     *
+     *  Each device is replayed in the order of its own records, so the operations of several
+     *  devices may be interleaved differently than when recorded. Each operation must match
+     *  the next record of its device (same register, direction, length and written value),
+     *  otherwise the replay fails. Reads return the recorded bytes, and recorded failures are
+     *  thrown again. In real time mode, each record is only replayed when its time (relative to
+     *  the first one) has come, otherwise the trace is replayed as fast as possible.
+     *
+     *  Multiplexers being devices too, the channels they are switched to depend on the order of
+     *  the operations behind them : several multiplexed devices are only replayed if they are
+     *  used in the recorded order
+     */
+    class i2c_replay_transport : public i2c_transport {
+
+        public:
+            /**
+             *  @brief Constructor
+             *  @param path     Path of the trace file
+             *  @param realTime If the records should be replayed in real time
+             *  Throws an exception if the trace can't be read
+             */
+            i2c_replay_transport(const std::string&, bool);
+
+            /**
+             *  @brief Destructor
+             */
+            virtual ~i2c_replay_transport();
+
+            void readBlock(uint16_t, uint8_t, uint8_t*, size_t);
+            void writeByte(uint16_t, uint8_t, uint8_t);
+            void sendByte(uint16_t, uint8_t);
+
+        private:
+            /**
+             * @brief Open the trace, and index its records by device
+             */
+            void index();
+
+            /**
+             * @brief Read a record at the current position of the trace. Throws an exception if
+             * the record is truncated
+             * @return False at the end of the trace
+             */
+            bool readRecord(i2cTraceRecord&);
+
+            /**
+             * @brief Read the next record of a device, for an operation. Throws an exception if
+             * the end of its records is reached, if the record doesn't match the operation, or if
+             * the recorded operation failed
+             * @param  address Address of the device
+             * @param  reg     Register read or written
+             * @param  flags   I2C_TRACE_READ or I2C_TRACE_SEND, or 0 for a write
+             * @param  data    Bytes written, or NULL for a read
+             * @param  len     Number of bytes read or written
+             * @return The record
+             */
+            const i2cTraceRecord& next(uint16_t, uint8_t, uint8_t, const uint8_t*, size_t);
+
+            std::string path;       // Path of the trace file
+            bool realTime;          // If the records should be replayed in real time
+            FILE* file;             // Trace file, or NULL
+            i2cTraceRecord current; // Last record read
+
+            std::map<uint16_t, std::deque<off_t>> records; // Offsets of the records not replayed yet, by device
+
+            bool started;                                   // If a record was already replayed
+            uint64_t firstTimestamp;                        // Timestamp of the first record of the trace
+            std::chrono::steady_clock::time_point firstTime; // Time of the first record replayed
+    };
+}
+
+#endif // H_I2C_TRACE_TRANSPORT
@@ -0,0 +1,136 @@
+/**
+ * @file i2c_transaction.h
+ * @brief Batch of I2C operations sent to a single device
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#ifndef H_I2C_TRANSACTION
+#define H_I2C_TRANSACTION
+
+#include <inttypes.h>
+#include <stddef.h>
+
+#include <vector>
+
+/**
+ * @namespace sensor
+ *
+ * Name space used to store every class and functions related to the sensors
+ */
+namespace sensor {
+
+    /**
+     * @brief Enum of the different I2C operations
+     */
+    enum i2cOperationType {
+        OPERATION_READ,  // Read consecutive registers
+        OPERATION_WRITE  // Write a byte in a register
+    };
+
+    typedef enum i2cOperationType i2cOperationType;
+
+    /**
+     * @brief Struct of a single I2C operation
+     */
+    struct i2cOperation {
+        i2cOperationType type;
+        uint8_t reg;      // Register where to read or write
+        uint8_t* buffer;  // Buffer to read into, for reads
+        size_t len;       // Number of bytes to read, for reads
+        uint8_t value;    // Value to write, for writes
+    };
+
+    /**
+     * @class i2c_transaction
+     * @brief Batch of I2C operations sent to a single device
+     *
+     *  The operations of a transaction are performed back to back by the bus executor,
+     *  without any other transaction in between. The buffers provided for the reads
+     *  should stay valid until the transaction is completed
+     */
+    class i2c_transaction {
+
+        public:
+            /**
+             *  @brief Constructor
+             *  @param address Address of the device
+             */
+            i2c_transaction(uint16_t);
+
+            /**
+             *  @brief Destructor
+             */
+            ~i2c_transaction();
+
+            /**
+             * @brief Add a read of consecutive registers, starting at the specified one
+             * @param  reg    The register where to start reading
+             * @param  buffer The buffer to read into
+             * @param  len    The number of bytes to read
+             * @return        The transaction itself
+             */
+            i2c_transaction& read(uint8_t, uint8_t*, size_t);
+
+            /**
+             * @brief Add a write of a byte in a register
+             * @param  reg   The register where to write at
+             * @param  value The value to write
+             * @return       The transaction itself
+             */
+            i2c_transaction& write(uint8_t, uint8_t);
+
+            /**
+             * @brief Set the route to the device, if it is behind a TCA9548A multiplexer
+             * @param mux     Address of the multiplexer, or -1 if none
+             * @param channel Channel of the device on the multiplexer, or -1 if none
+             */
+            void setRoute(int, int);
+
+            /**
+             * @brief Set if the transaction is accounted in the statistics and the circuit breaker of
+             * its device. Probes of a scan are not, so absent devices leave no trace
+             * @param accounted If the transaction is accounted
+             */
+            void setAccounted(bool);
+
+            /**
+             * @brief Return if the transaction is accounted in the statistics and the circuit breaker
+             * @return True if the transaction is accounted
+             */
+            bool isAccounted();
+
+            /**
+             * @brief Return the address of the device
+             * @return The address of the device
+             */
+            uint16_t getAddress();
+
+            /**
+             * @brief Return the address of the multiplexer of the device
+             * @return The address of the multiplexer, or -1 if none
+             */
+            int getMux();
+
+            /**
+             * @brief Return the channel of the device on its multiplexer
+             * @return The channel of the device, or -1 if none
+             */
+            int getChannel();
+
+            /**
+             * @brief Return the operations of the transaction, in order
+             * @return The operations of the transaction
+             */
+            const std::vector<i2cOperation>& getOperations();
+
+        private:
+            uint16_t address;                     // Address of the device
+            int mux;                              // Address of the multiplexer, or -1
+            int channel;                          // Channel on the multiplexer, or -1
+            bool accounted;                       // If accounted in the statistics and the circuit breaker
+            std::vector<i2cOperation> operations; // Operations to perform
+    };
+}
+
+#endif // H_I2C_TRANSACTION
@@ -0,0 +1,84 @@
+/**
+ * @file i2c_transport.h
+ * @brief Interface of the transports used to talk to an I2C bus
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#ifndef H_I2C_TRANSPORT
+#define H_I2C_TRANSPORT
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include <string>
+
+#include "sensor.h"
+
+#ifndef I2C_BUS_FILE
+    // Default i2c bus, used when none is specified. Should be setted from from node-gyp
+    #define I2C_BUS_FILE "/dev/i2c-1"
+#endif
+
+/**
+ * @namespace sensor
+ *
+ * Name space used to store every class and functions related to the sensors
+ */
+namespace sensor {
+
+    /**
+     * @class i2c_transport
+     * @brief Interface of the transports used to talk to an I2C bus
+     *
+     *  A transport performs the register level operations on the devices of a bus. Transports
+     *  are only used by the executor of their bus, and don't need to be thread safe
+     */
+    class i2c_transport {
+
+        public:
+            /**
+             * @brief Destructor
+             */
+            virtual ~i2c_transport() {};
+
+            /**
+             * @brief Read consecutive registers of a device, starting at the specified one. Throws
+             * an exception on failure
+             * @param address Address of the device
+             * @param reg     The register where to start reading
+             * @param buffer  The buffer to read into
+             * @param len     The number of bytes to read
+             */
+            virtual void readBlock(uint16_t, uint8_t, uint8_t*, size_t) = 0;
+
+            /**
+             * @brief Write a byte in a register of a device. Throws an exception on failure
+             * @param address Address of the device
+             * @param reg     The register where to write at
+             * @param value   The value to write
+             */
+            virtual void writeByte(uint16_t, uint8_t, uint8_t) = 0;
+
+            /**
+             * @brief Send a single byte to a device, without any register (e.g. the control
+             * byte of a multiplexer). Throws an exception on failure
+             * @param address Address of the device
+             * @param value   The value to send
+             */
+            virtual void sendByte(uint16_t, uint8_t) = 0;
+
+            /**
+             * @brief Create the transport of the specified bus. A bus is either the path of an
+             * i2c-dev file (e.g. /dev/i2c-1), 'sim[:<clock in kHz>]' for a simulated bus,
+             * 'record:<trace file>[:<bus>]' to record the transactions of another bus, or
+             * 'replay:<trace file>' and 'replay-realtime:<trace file>' to replay a trace
+             * @param  path The bus
+             * @return      The transport created
+             */
+            static i2c_transport* create(const std::string&);
+    };
+}
+
+#endif // H_I2C_TRANSPORT
@@ -26,22 +26,6 @@
  */
 namespace scheduler {
 
-    /**
-     * @brief Prototype for the asynchonous action
-     *
-     * @param req The libuv information
-     */
-    void AsyncAction(uv_work_t* req);
-
-    /**
-     * @brief Prototype for the synchonous action taking place after the
-     * asynchonous action previously defined
-     *
-     * @param req    The libuv information
-     * @param status The libuv status
-     */
-    void AsyncActionAfter(uv_work_t* req, int status);
-
     template<typename T1, typename T2>
     class scheduler;
     
@@ -51,8 +35,10 @@ namespace scheduler {
     template<typename T1, typename T2>
     struct schedulerBaton {
         uv_work_t request;         // libuv
+        uv_timer_t timer;          // libuv timer, delaying the retries
         scheduler<T1, T2> *handle; // scheduler itself
         T2 resultValue;            // result of the async action
+        bool retrying;             // If the action is a retry, performed without waiting the frequence
     };
 
     /**
@@ -73,46 +59,7 @@ namespace scheduler {
         using schedulerAction = std::function<T2(T1)>;
         using schedulerCallback = std::function<void(T1, T2)>;
         using schedulerCleanup = std::function<void()>;
-        
-        friend void AsyncAction(uv_work_t* req) {
-            schedulerBaton<T1, T2>* baton = static_cast<schedulerBaton<T1, T2>*>(req->data);
-            scheduler<T1, T2>* handle = baton->handle;
-
-            // Lock and wait for the time/cancellation
-            if(handle->frequence > 0) {
-                std::unique_lock<std::mutex> l(handle->m);
-                handle->stop_threads.wait_for(l, std::chrono::seconds(handle->frequence));
-            }
-
-            // Call the async action
-            baton->resultValue = handle->action(handle->producer);
-        }
-
-        friend void AsyncActionAfter(uv_work_t* req, int status) {
-            schedulerBaton<T1, T2>* baton = static_cast<schedulerBaton<T1, T2>*>(req->data);
-            scheduler<T1, T2>* handle = baton->handle;
-            
-            // If canceled, quit now
-            if(handle->cancelled)
-                goto quit;
-
-            // Call callback with result
-            handle->callback(handle->producer, baton->resultValue);
-
-            // Re-launch the thread
-            if(handle->repeat)
-                uv_queue_work(uv_default_loop(), &baton->request, AsyncAction, AsyncActionAfter);
-            else
-                goto quit; // Not to relaunch, quit
-
-            return;
-
-            quit:
-            delete baton;
-            if(handle->cleanup)
-                handle->cleanup(); // If any cleanup method is defined, call it
-            delete handle;
-        }
+        using schedulerRetry = std::function<int(T1, T2&)>;
 
         public:
             /**
@@ -159,6 +106,17 @@ namespace scheduler {
              */
             ~scheduler() {}
             
+            /**
+             * @brief Set when a result should be retried instead of being provided to the callback. Must be
+             * called before the scheduler is launched
+             *
+             * @param _retry Lambda called on the main thread with the producer and the result, returning the delay
+             *               before the retry (ms), or a negative value to provide the result to the callback
+             */
+            void setRetry(schedulerRetry _retry) {
+                retry = _retry;
+            }
+
             /**
              * Launch all the sensors' workers. If already launched, this method has no effect
              */
@@ -174,8 +132,11 @@ namespace scheduler {
                 schedulerBaton<T1, T2> *baton = new schedulerBaton<T1, T2>;
                 
                 baton->request.data = baton;
+                baton->timer.data = baton;
                 baton->handle = this;
-                
+                baton->retrying = false;
+
+                uv_timer_init(uv_default_loop(), &baton->timer);
                 uv_queue_work(uv_default_loop(), &baton->request, AsyncAction, AsyncActionAfter);
             }
 
@@ -191,9 +152,102 @@ namespace scheduler {
             }
 
         private:
+            /**
+             * @brief Asynchronous action, performed in the libuv thread pool
+             *
+             * @param req The libuv information
+             */
+            static void AsyncAction(uv_work_t* req) {
+                schedulerBaton<T1, T2>* baton = static_cast<schedulerBaton<T1, T2>*>(req->data);
+                scheduler<T1, T2>* handle = baton->handle;
+
+                // Lock and wait for the time/cancellation, unless retrying
+                if(handle->frequence > 0 && !baton->retrying) {
+                    std::unique_lock<std::mutex> l(handle->m);
+                    handle->stop_threads.wait_for(l, std::chrono::seconds(handle->frequence));
+                }
+
+                // Call the async action
+                baton->resultValue = handle->action(handle->producer);
+            }
+
+            /**
+             * @brief Synchronous action taking place after the asynchronous action, on the main thread
+             *
+             * @param req    The libuv information
+             * @param status The libuv status
+             */
+            static void AsyncActionAfter(uv_work_t* req, int status) {
+                schedulerBaton<T1, T2>* baton = static_cast<schedulerBaton<T1, T2>*>(req->data);
+                scheduler<T1, T2>* handle = baton->handle;
+
+                // If canceled, quit now
+                if(handle->cancelled) {
+                    quit(baton);
+                    return;
+                }
+
+                // Retry later if needed, without blocking any thread in the meantime
+                if(handle->retry) {
+                    int delay = handle->retry(handle->producer, baton->resultValue);
+
+                    if(delay >= 0) {
+                        uv_timer_start(&baton->timer, AsyncRetry, (uint64_t) delay, 0);
+                        return;
+                    }
+                }
+
+                baton->retrying = false;
+
+                // Call callback with result
+                handle->callback(handle->producer, baton->resultValue);
+
+                // Re-launch the thread
+                if(handle->repeat)
+                    uv_queue_work(uv_default_loop(), &baton->request, AsyncAction, AsyncActionAfter);
+                else
+                    quit(baton); // Not to relaunch, quit
+            }
+
+            /**
+             * @brief Relaunch the asynchronous action once the retry delay has elapsed
+             *
+             * @param timer The libuv timer
+             */
+            static void AsyncRetry(uv_timer_t* timer) {
+                schedulerBaton<T1, T2>* baton = static_cast<schedulerBaton<T1, T2>*>(timer->data);
+
+                // If canceled in the meantime, quit now
+                if(baton->handle->cancelled) {
+                    quit(baton);
+                    return;
+                }
+
+                baton->retrying = true;
+                uv_queue_work(uv_default_loop(), &baton->request, AsyncAction, AsyncActionAfter);
+            }
+
+            /**
+             * @brief Free the scheduler. The baton is freed once its timer is closed
+             *
+             * @param baton The baton of the scheduler
+             */
+            static void quit(schedulerBaton<T1, T2>* baton) {
+                scheduler<T1, T2>* handle = baton->handle;
+
+                uv_close((uv_handle_t*) &baton->timer, [](uv_handle_t* timer) {
+                    delete static_cast<schedulerBaton<T1, T2>*>(timer->data);
+                });
+
+                if(handle->cleanup)
+                    handle->cleanup(); // If any cleanup method is defined, call it
+                delete handle;
+            }
+
             schedulerAction action;               // Action
             schedulerCallback callback;           // Callback
             schedulerCleanup cleanup;             // Cleanup
+            schedulerRetry retry;                 // Retry delay of a result, if any
         
             unsigned frequence;
             T1 producer;
@@ -13,6 +13,7 @@
 #include <exception>
 #include <stdexcept>
 #include <functional>
+#include <chrono>
 
 #include <time.h>
 
@@ -36,7 +37,9 @@ namespace sensor {
         FILE_ERROR,
         I2C_ERROR,
         GPIO_ERROR,
-        INVALID_VALUE
+        INVALID_VALUE,
+        NOT_READY, // The sensor can't be sampled yet
+        TIMEOUT    // The sensor answered, but did not complete an operation in time
     };
     
     typedef enum sensorErrorCode sensorErrorCode;
@@ -49,12 +52,24 @@ namespace sensor {
 
         public:
             sensorException();
-            sensorException(const std::string&, sensorErrorCode);
+            sensorException(const std::string&, sensorErrorCode, int = 0);
             virtual const char* what();
             sensorErrorCode code();
+            int systemError();
+
+            /**
+             * @brief Ask for the failed fetch to be retried at the given time, instead of reporting the error
+             * @param time When the fetch should be retried
+             */
+            void setRetry(std::chrono::steady_clock::time_point);
+            bool isRetryable();
+            std::chrono::steady_clock::time_point retryTime();
 
         private:
             sensorErrorCode errorCode;
+            int errorNumber; // errno of the failed system call, or 0
+            bool retryable;  // If the fetch should be retried
+            std::chrono::steady_clock::time_point retryAt; // When the fetch should be retried
     };
 
     /**
@@ -128,6 +143,23 @@ namespace sensor {
      */
     enum sensorType { GPIO, I2C };
 
+    /**
+     * @brief Struct of the optional configuration values for a sensor, read in the file
+     * wrapper_sensor.cc
+     */
+    struct sensorOptions {
+        std::string bus; // Bus file of I2C sensors (e.g. /dev/i2c-1), or GPIO backend of GPIO sensors (e.g. /dev/gpiochip0), empty for the default one
+        int mux = -1;     // Address of the TCA9548A multiplexer of I2C sensors, or -1 if none
+        int channel = -1; // Channel of I2C sensors on their multiplexer, or -1 if none
+        int oversampling = 0; // Oversampling of BMP180 sensors, from 0 (ultra low power) to 3 (ultra high resolution)
+        unsigned temperatureRefresh = 0; // Pressure samples of BMP180 sensors between two temperature conversions, or 0 for no limit
+        unsigned temperatureMaxAge = 0;  // Maximum age of the temperature compensation of BMP180 sensors (ms), or 0
+        int package = 1;        // Package of TSL2561 sensors, 0 for T, FN and CL or 1 for CS
+        int interruptPin = -1;  // Pin of the interrupt line of TSL2561 sensors in event mode, or -1
+        unsigned threshold = 10; // Variation of the light triggering an event, for TSL2561 sensors in event mode (%)
+        unsigned lastGood = 0;   // Maximum age of the last good values of DHT sensors, returned when a read fails (ms), or 0
+    };
+
     /**
      * @brief Struct of the necessary configuration values for a sensor, using in the file
      * wrapper_sensor.cc
@@ -135,7 +167,7 @@ namespace sensor {
     struct sensorConf {
         std::string type;
         sensorType bus;
-        std::function<sensor* (int, const std::string&)> factory;
+        std::function<sensor* (int, const std::string&, const sensorOptions&)> factory;
     };
 }
 
@@ -63,10 +63,17 @@ namespace sensor {
             resultTimestamp getTime();
             long long getTimestamp();
 
+            /**
+             * @brief Mark the result as stale, i.e. returned again in place of a failed read
+             */
+            void setStale();
+            bool isStale();
+
         private:
             resultValue r;     // Data of the result
             resultType t;      // Type of the data
             resultTimestamp date;  // Date of creation
+            bool stale;        // If returned again in place of a failed read
     };
 
     class sensorException;
@@ -87,6 +94,12 @@ namespace sensor {
             bool hasError();
             bool hasResults();
 
+            /**
+             * @brief Return when the failed fetch should be retried, instead of reporting its error
+             * @return The delay before the retry (ms), or -1 if the error should be reported
+             */
+            int getRetryDelay();
+
         private:
             sensorException error;     // Error, if any occured
             std::list<result> results; // Result, if no error
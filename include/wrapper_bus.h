@@ -0,0 +1,42 @@
+/**
+ * @file wrapper_bus.h
+ * @brief Wrapper functions for inspecting the I2C buses from nodejs plugin
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#ifndef BUS_WRAPPER_H
+#define BUS_WRAPPER_H
+
+#include <node.h>
+
+#include "format.h"
+
+#include "i2c_bus.h"
+#include "i2c_scan.h"
+#include "scheduler.h"
+
+using namespace v8;
+
+
+/**
+ * @class BusWrapper
+ * @brief NodeJS exposed functions related to the I2C buses
+ */
+class BusWrapper {
+
+	public:
+		static void Init(Local<Object> exports);
+
+	private:
+		// Private method used to convert the statistics
+		static Local<Object> ConvertStats(const sensor::i2cStats& stats, Isolate* isolate);
+		static void SendScan(const std::string& bus, sensor::i2cScanResult& r, Isolate* isolate, Local<Function>& cb);
+
+		// Node exported methods
+		static void Stats(const FunctionCallbackInfo<Value>& args);
+		static void Scan(const FunctionCallbackInfo<Value>& args);
+};
+
+
+#endif // BUS_WRAPPER_H
@@ -35,6 +35,8 @@ class SensorWrapper : public node::ObjectWrap {
 
 		// Private method used to generate a sensor and a result
 		static sensor::sensor* InitSensor(const Local<String>& sensorName, const Local<Object>& sensorConfig);
+		static sensor::sensorOptions InitOptions(const Local<Object>& sensorConfig, sensor::sensorType type);
+		static int InitPackage(const Local<Value>& value);
 		static void SendResult(sensor::sensor* s, sensor::result& r, Isolate* isolate, Local<Function>& cb);
 		static void SendError(sensor::sensor* s, sensor::sensorException& r, Isolate* isolate, Local<Function>& cb);
 		
@@ -46,6 +48,9 @@ class SensorWrapper : public node::ObjectWrap {
 		static void Fetch(const FunctionCallbackInfo<Value>& args);
 		static void FetchInterval(const FunctionCallbackInfo<Value>& args);
 		static void FetchClear(const FunctionCallbackInfo<Value>& args);
+		static void CompensateBMP180(const FunctionCallbackInfo<Value>& args);
+		static void LuxTSL2561(const FunctionCallbackInfo<Value>& args);
+		static void DecodeDHT(const FunctionCallbackInfo<Value>& args);
 
 		static Persistent<Function> constructor;
 		sensor::sensor* _s;
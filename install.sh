@@ -12,8 +12,21 @@ while true; do
     esac
 done
 
+# if wiringPi should be used for GPIO sensors, on kernels without the GPIO character device v2
+wiringpi=false
+if [ "$gpio" = true ]; then
+    while true; do
+        read -p "Do you want to use wiringPi for GPIO sensors (only needed before Linux 5.10) ? (Y/n) " wiringpi
+        case $wiringpi in
+            ''|[Yy]* ) wiringpi=true; break;;
+            [Nn]* ) wiringpi=false; break;;
+            * ) echo "Please answer yes or no";;
+        esac
+    done
+fi
+
 while true; do
-    read -p "i2c needs to be functioning, where is located the i2c bus to use ? (/dev/i2c-1) " i2c_file
+    read -p "i2c needs to be functioning, where is located the default i2c bus to use ? (/dev/i2c-1) " i2c_file
     case $i2c_file in
         '' ) i2c_file='/dev/i2c-1'; break;;
         * ) break;;
@@ -38,7 +51,7 @@ fi
 
 echo "Now running node-gyp configure..."
 
-node-gyp configure --i2c-bus-file="$i2c_file" --gpio="$gpio"
+node-gyp configure --i2c-bus-file="$i2c_file" --gpio="$gpio" --wiringpi="$wiringpi"
 if [ $? -ne 0 ]; then
 	exit $?;
 fi
@@ -10,9 +10,22 @@
 
 #include "BMP180.h"
 
+#include <string.h>
+
+#include <chrono>
+#include <algorithm>
+
 namespace sensor {
 
-    BMP180_sensor::BMP180_sensor(uint16_t deviceAddress, std::string _name):i2c_sensor(deviceAddress, _name) {}
+    BMP180_sensor::BMP180_sensor(uint16_t deviceAddress, std::string _name, const sensorOptions& options):i2c_sensor(deviceAddress, _name, options) {
+        oss = (uint16_t) std::min(std::max(options.oversampling, 0), 3);
+        temperatureRefresh = options.temperatureRefresh;
+        temperatureMaxAge = std::chrono::milliseconds(options.temperatureMaxAge);
+
+        // Without any limit, the temperature is measured for every pressure sample
+        if(temperatureRefresh == 0 && temperatureMaxAge.count() == 0)
+            temperatureRefresh = 1;
+    }
 
     BMP180_sensor::~BMP180_sensor() {};
 
@@ -21,117 +34,142 @@ namespace sensor {
     }
 
     void BMP180_sensor::prepare() {
-        ac1 = readRegisterInt(0xAA);
-        ac2 = readRegisterInt(0xAC);
-        ac3 = readRegisterInt(0xAE);
-        ac4 = readRegisterInt(0xB0);
-        ac5 = readRegisterInt(0xB2);
-        ac6 = readRegisterInt(0xB4);
-        b1 = readRegisterInt(0xB6);
-        b2 = readRegisterInt(0xB8);
-        mb = readRegisterInt(0xBA);
-        mc = readRegisterInt(0xBC);
-        md = readRegisterInt(0xBE);
+        if(!calibrated)
+            recalibrate();
     }
 
-    /**
-     * @brief Read the uncompensated temperature
-     * @return The uncompensated temperature
-     */
-    int32_t BMP180_sensor::readUT() {
-        // Write 0x2E at register 0xF4
-        writeRegister(0xF4, 0x2E);
-
-        // Wait for 4.5ms / 4500 microsecondes
-        microsecondSleep(4500);
-
-        // Read register 0xF6 (MSB), 0xF7 (LSB), and 0xF8 (XLSB)
-        uint16_t msb = readRegister(0xF6);
-        uint16_t lsb = readRegister(0xF7);
-
-        return (msb << 8) + lsb;
+    void BMP180_sensor::recalibrate() {
+        // Read the 11 calibration words, from 0xAA to 0xBF (MSB first)
+        uint8_t buffer[22];
+        uint16_t words[11];
+
+        readRegisterBlock(0xAA, buffer, 22);
+
+        for(unsigned i = 0; i < 11; i++) {
+            words[i] = (buffer[i * 2] << 8) | buffer[i * 2 + 1];
+
+            // Each word should never be 0x0000 or 0xFFFF, which are communication errors
+            if(words[i] == 0x0000 || words[i] == 0xFFFF) {
+                calibrated = false;
+                throw sensorException(fmt::format("Invalid BMP180 calibration data : 0x{0:04x} read at 0x{1:x}", words[i], 0xAA + i * 2),
+                                      sensorErrorCode::INVALID_VALUE);
+            }
+        }
+
+        calibration.ac1 = words[0];
+        calibration.ac2 = words[1];
+        calibration.ac3 = words[2];
+        calibration.ac4 = words[3];
+        calibration.ac5 = words[4];
+        calibration.ac6 = words[5];
+        calibration.b1 = words[6];
+        calibration.b2 = words[7];
+        calibration.mb = words[8];
+        calibration.mc = words[9];
+        calibration.md = words[10];
+
+        calibrated = true;
+        compensated = false; // b5 depends on the calibration
     }
 
-    int32_t BMP180_sensor::readUP() {
-        // Write 0x34 at register 0xF4
-        writeRegister(0xF4, 0x34 + (oss << 6));
+    void BMP180_sensor::convert(uint8_t command, unsigned mode, uint8_t* buffer, size_t len) {
+        // Maximum conversion times, in microsecondes
+        static const int conversionTimes[5] = { 4500, 4500, 7500, 13500, 25500 };
 
-        // Sleep for 2ms + 3ms << oss
-        microsecondSleep((2 + (3 << oss)) * 1000);
+        // Start the conversion, and sleep for most of it. The deadline only starts once the
+        // write is done, not counting the time spent waiting for the bus
+        writeRegister(0xF4, command);
 
-        // Read register 0xF6 (MSB), 0xF7 (LSB), and 0xF8 (XLSB)
-        uint32_t msb = readRegister(0xF6);
-        uint32_t lsb = readRegister(0xF7);
-        uint32_t xlsb = readRegister(0xF8);
+        std::chrono::steady_clock::time_point timeout = std::chrono::steady_clock::now() + std::chrono::microseconds(conversionTimes[mode] * 2);
+        microsecondSleep(conversionWait[mode]);
 
-        return ((msb << 16) + (lsb << 8) + xlsb) >> (8 - oss);
-    }
+        // Poll the SCO bit of 0xF4, and read the result along with it. The conversion only times
+        // out once both the deadline and the polls fitting in it are exhausted : the sleeps of a
+        // loaded system may exceed the deadline in fewer polls, and a replayed trace should fail
+        // the same way as when recorded, whatever the time taken
+        uint8_t registers[5];
+        unsigned polls = 0;
+        unsigned maxPolls = (conversionTimes[mode] * 2 - conversionWait[mode]) / BMP180_POLL_INTERVAL;
 
-    float BMP180_sensor::convertTemperature(uint16_t ut) {
-        int32_t x1, x2;
+        while(true) {
+            // Checked before the read, so the SCO bit is read once more after the deadline
+            bool late = std::chrono::steady_clock::now() > timeout;
 
-        x1 = ((ut - ac6) * ac5) >> 15;
-        x2 = (mc << 11) / (x1 + md);
+            readRegisterBlock(0xF4, registers, 2 + len);
 
-        b5 = x1 + x2;
+            if(!(registers[0] & 0x20))
+                break;
 
-        return ((b5 + 8) >> 4) / 10.0;
-    }
+            if(late && polls >= maxPolls)
+                throw sensorException("BMP180 conversion not completed in time", sensorErrorCode::TIMEOUT);
 
-    long BMP180_sensor::convertPressure(unsigned long up) {
-        int32_t x1, x2, x3, b3, b6, p;
-        uint32_t b4, b7;
+            polls++;
+            microsecondSleep(BMP180_POLL_INTERVAL);
+        }
 
-        b6 = b5 - 4000;
-        x1 = (b2 * (b6 * b6) >> 12) >> 11;
-        x2 = (ac2 * b6) >> 11;
-        x3 = x1 + x2;
-        b3 = (((ac1 * 4 + x3) << oss) + 2) >> 2;
+        // Wait less next time if the conversion was already completed, or more if it was not
+        if(polls == 0)
+            conversionWait[mode] = std::max(conversionWait[mode] - BMP180_POLL_INTERVAL, BMP180_POLL_INTERVAL);
+        else
+            conversionWait[mode] = std::min(conversionWait[mode] + (int) polls * BMP180_POLL_INTERVAL, conversionTimes[mode]);
 
-        x1 = (ac3 * b6) >> 13;
-        x2 = (b1 * ((b6 * b6) >> 12)) >> 16;
-        x3 = ((x1 + x2) + 2) >> 2;
-        b4 = (ac4 * (uint32_t)(x3 + 32768)) >> 15;
+        memcpy(buffer, registers + 2, len);
+    }
 
-        b7 = ((uint32_t)up - b3) * (50000 >> oss);
+    /**
+     * @brief Read the uncompensated temperature
+     * @return The uncompensated temperature
+     */
+    int32_t BMP180_sensor::readUT() {
+        // Write 0x2E at register 0xF4, then read register 0xF6 (MSB) and 0xF7 (LSB)
+        uint8_t buffer[2];
+        convert(0x2E, 0, buffer, 2);
 
-        if(b7 < 0x80000000)
-            p = (b7 << 1) / b4;
-        else
-            p = (b7/b4) << 1;
+        return (buffer[0] << 8) + buffer[1];
+    }
 
-        x1 = (p >> 8) * (p >> 8);
-        x1 = (x1 * 3038) >> 16;
-        x2 = (-7357 * p) >> 16;
+    int32_t BMP180_sensor::readUP() {
+        // Write 0x34 at register 0xF4, then read register 0xF6 (MSB), 0xF7 (LSB), and 0xF8 (XLSB)
+        uint8_t buffer[3];
+        convert(0x34 + (oss << 6), 1 + oss, buffer, 3);
 
-        return p + ((x1 + x2 + 3791) >> 4);
+        return (((uint32_t) buffer[0] << 16) + ((uint32_t) buffer[1] << 8) + buffer[2]) >> (8 - oss);
     }
 
     std::list<result> BMP180_sensor::getResults() {
         std::list<result> results;
 
+        // The temperature changes slowly, so its compensation may be reused for several pressure samples
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        bool refresh = !compensated || (temperatureRefresh > 0 && pressureSamples >= temperatureRefresh) ||
+                       (temperatureMaxAge.count() > 0 && now - compensationTime >= temperatureMaxAge);
+
         // Read the result from the sensor
-        float temp = convertTemperature(readUT());
-        float pressure = convertPressure(readUP());
+        if(refresh) {
+            b5 = BMP180_compensation::computeB5(calibration, readUT());
+            float temp = BMP180_compensation::temperature(b5);
 
-        // Init the data
-        resultValue tempValue;
-        tempValue.f = temp;
-        result tempResult(resultType::TEMPERATURE, tempValue);
+            compensated = true;
+            compensationTime = now;
+            pressureSamples = 0;
+
+            resultValue tempValue;
+            tempValue.f = temp;
+            results.push_back(result(resultType::TEMPERATURE, tempValue));
+        }
+
+        float pressure = BMP180_compensation::pressure(calibration, b5, readUP(), oss);
+        pressureSamples++;
 
         resultValue pressureValue;
         pressureValue.f = pressure;
-        result pressureResult(resultType::PRESSURE, pressureValue);
-
-        // Return
-        results.push_back(tempResult);
-        results.push_back(pressureResult);
+        results.push_back(result(resultType::PRESSURE, pressureValue));
 
         return results;
     }
 
-    sensor* BMP180_sensor::create(int pin, const std::string& name) {
-        return (sensor*) new BMP180_sensor((uint16_t) pin, name);
+    sensor* BMP180_sensor::create(int pin, const std::string& name, const sensorOptions& options) {
+        return (sensor*) new BMP180_sensor((uint16_t) pin, name, options);
     }
 }
 
@@ -0,0 +1,115 @@
+/**
+ * @file BMP180_compensation.cc
+ * @brief Stateless compensation of the raw BMP180 temperatures and pressures implementation
+ * @author Vuzi
+ * @version 0.2
+ * Based on https://github.com/BoschSensortec/BMP180_driver/blob/master/bmp180.c
+ */
+
+#include "BMP180_compensation.h"
+
+#include <algorithm>
+
+namespace sensor {
+
+    int32_t BMP180_compensation::computeB5(const bmp180Calibration& c, int32_t ut) {
+        int32_t x1, x2;
+
+        x1 = ((ut - c.ac6) * c.ac5) >> 15;
+        x2 = (c.mc << 11) / (x1 + c.md);
+
+        return x1 + x2;
+    }
+
+    bool BMP180_compensation::isComputable(const bmp180Calibration& c, int32_t ut) {
+        int32_t x1 = ((ut - c.ac6) * c.ac5) >> 15;
+
+        if(x1 + c.md == 0)
+            return false;
+
+        // Divisor of the pressure (b4)
+        int32_t b6 = x1 + (c.mc << 11) / (x1 + c.md) - 4000;
+        int32_t x3 = (((c.ac3 * b6) >> 13) + ((c.b1 * ((b6 * b6) >> 12)) >> 16) + 2) >> 2;
+
+        return ((c.ac4 * (uint32_t)(x3 + 32768)) >> 15) != 0;
+    }
+
+    float BMP180_compensation::temperature(int32_t b5) {
+        return ((b5 + 8) >> 4) / 10.0;
+    }
+
+    int32_t BMP180_compensation::pressure(const bmp180Calibration& c, int32_t b5, int32_t up, uint16_t oss) {
+        int32_t x1, x2, x3, b3, b6, p;
+        uint32_t b4, b7;
+
+        b6 = b5 - 4000;
+        x1 = (c.b2 * (b6 * b6) >> 12) >> 11;
+        x2 = (c.ac2 * b6) >> 11;
+        x3 = x1 + x2;
+        b3 = (((c.ac1 * 4 + x3) << oss) + 2) >> 2;
+
+        x1 = (c.ac3 * b6) >> 13;
+        x2 = (c.b1 * ((b6 * b6) >> 12)) >> 16;
+        x3 = ((x1 + x2) + 2) >> 2;
+        b4 = (c.ac4 * (uint32_t)(x3 + 32768)) >> 15;
+
+        b7 = ((uint32_t)up - b3) * (50000 >> oss);
+
+        if(b7 < 0x80000000)
+            p = (b7 << 1) / b4;
+        else
+            p = (b7/b4) << 1;
+
+        x1 = (p >> 8) * (p >> 8);
+        x1 = (x1 * 3038) >> 16;
+        x2 = (-7357 * p) >> 16;
+
+        return p + ((x1 + x2 + 3791) >> 4);
+    }
+
+    void BMP180_compensation::compensate(const bmp180Calibration& c, uint16_t oss, size_t count, const int32_t* ut, const int32_t* up,
+                                         float* temperatures, int32_t* pressures) {
+        // Intermediate values of a block of samples, small enough to stay in cache
+        int32_t b5[BMP180_COMPENSATION_BLOCK], b3[BMP180_COMPENSATION_BLOCK], p[BMP180_COMPENSATION_BLOCK];
+        uint32_t b4[BMP180_COMPENSATION_BLOCK], b7[BMP180_COMPENSATION_BLOCK];
+
+        for(size_t start = 0; start < count; start += BMP180_COMPENSATION_BLOCK) {
+            const size_t n = std::min(count - start, (size_t) BMP180_COMPENSATION_BLOCK);
+            const int32_t* blockUt = ut + start;
+            const int32_t* blockUp = up + start;
+
+            // Temperatures
+            for(size_t i = 0; i < n; i++)
+                b5[i] = ((blockUt[i] - c.ac6) * c.ac5) >> 15;
+
+            for(size_t i = 0; i < n; i++)
+                b5[i] += (c.mc << 11) / (b5[i] + c.md);
+
+            for(size_t i = 0; i < n; i++)
+                temperatures[start + i] = ((b5[i] + 8) >> 4) / 10.0f;
+
+            // Pressures
+            for(size_t i = 0; i < n; i++) {
+                int32_t b6 = b5[i] - 4000;
+                int32_t x3 = ((c.b2 * (b6 * b6) >> 12) >> 11) + ((c.ac2 * b6) >> 11);
+
+                b3[i] = (((c.ac1 * 4 + x3) << oss) + 2) >> 2;
+
+                x3 = (((c.ac3 * b6) >> 13) + ((c.b1 * ((b6 * b6) >> 12)) >> 16) + 2) >> 2;
+                b4[i] = (c.ac4 * (uint32_t)(x3 + 32768)) >> 15;
+                b7[i] = ((uint32_t)blockUp[i] - b3[i]) * (50000 >> oss);
+            }
+
+            for(size_t i = 0; i < n; i++)
+                p[i] = (b7[i] < 0x80000000) ? (b7[i] << 1) / b4[i] : (b7[i] / b4[i]) << 1;
+
+            for(size_t i = 0; i < n; i++) {
+                int32_t x1 = (((p[i] >> 8) * (p[i] >> 8)) * 3038) >> 16;
+                int32_t x2 = (-7357 * p[i]) >> 16;
+
+                pressures[start + i] = p[i] + ((x1 + x2 + 3791) >> 4);
+            }
+        }
+    }
+
+}
@@ -0,0 +1,94 @@
+/**
+ * @file BMP180_sim.cc
+ * @brief Simulated BMP180 device implementation
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#include "BMP180_sim.h"
+
+namespace sensor {
+
+    // Calibration EEPROM of the datasheet example, from ac1 to md
+    static const int16_t calibration[11] = { 408, -72, -14383, 32741, 32757, 23153, 6190, 4, -32768, -8711, 2868 };
+
+    BMP180_sim_device::BMP180_sim_device() {
+        memset(registers, 0x0, sizeof(registers));
+
+        for(int i = 0; i < 11; i++) {
+            registers[0xAA + i * 2] = (uint16_t) calibration[i] >> 8;
+            registers[0xAB + i * 2] = (uint16_t) calibration[i] & 0xFF;
+        }
+
+        registers[0xD0] = 0x55; // Chip id
+
+        ut = 27898;
+        up = 23843;
+        converting = false;
+    }
+
+    BMP180_sim_device::~BMP180_sim_device() {}
+
+    void BMP180_sim_device::setRawValues(int32_t _ut, int32_t _up) {
+        ut = _ut;
+        up = _up;
+    }
+
+    void BMP180_sim_device::update() {
+        if(!converting || std::chrono::steady_clock::now() < conversionEnd)
+            return;
+
+        uint8_t control = registers[0xF4];
+        uint32_t value;
+
+        if((control & 0x1F) == 0x0E) {
+            // Temperature, 16 bits
+            value = (uint32_t) ut << 8;
+        } else {
+            // Pressure, up to 19 bits depending on the oversampling
+            uint8_t oss = control >> 6;
+            value = ((uint32_t) up << oss) << (8 - oss);
+        }
+
+        registers[0xF6] = (value >> 16) & 0xFF;
+        registers[0xF7] = (value >> 8) & 0xFF;
+        registers[0xF8] = value & 0xFF;
+
+        registers[0xF4] = control & ~0x20; // Clear SCO
+        converting = false;
+    }
+
+    void BMP180_sim_device::read(uint8_t reg, uint8_t* buffer, size_t len) {
+        update();
+
+        for(size_t i = 0; i < len; i++)
+            buffer[i] = registers[(uint8_t)(reg + i)];
+    }
+
+    void BMP180_sim_device::write(uint8_t reg, uint8_t value) {
+        // Conversion times in microseconds : temperature, then pressure for each oversampling
+        static const int conversionTimes[5] = { 4500, 4500, 7500, 13500, 25500 };
+
+        update();
+
+        if(reg == 0xF4) {
+            int duration;
+
+            if((value & 0x1F) == 0x0E)
+                duration = conversionTimes[0];
+            else if((value & 0x1F) == 0x14)
+                duration = conversionTimes[1 + (value >> 6)];
+            else
+                return; // Unknown measurement
+
+            registers[0xF4] = value | 0x20; // Set SCO
+            converting = true;
+            conversionEnd = std::chrono::steady_clock::now() + std::chrono::microseconds(duration);
+        } else if(reg == 0xE0 && value == 0xB6) {
+            // Soft reset
+            registers[0xF4] = 0x0;
+            converting = false;
+        }
+    }
+
+}
@@ -0,0 +1,119 @@
+/**
+ * @file DHT.cc
+ * @brief Class implementation for all DHT sensors
+ * @author Vuzi
+ * @version 0.2
+ * Based on https://github.com/adafruit/DHT-sensor-library and on https://github.com/Seeed-Studio/Grove-RaspberryPi
+ */
+
+#include "DHT.h"
+
+namespace sensor {
+
+    template<dhtVariant V>
+    DHT_sensor<V>::DHT_sensor(unsigned _pin, std::string _name, const std::string& _backend, unsigned _lastGood)
+        :gpio_sensor(_pin, _name, _backend), failures(0), lastGoodMaxAge(_lastGood) {}
+
+    template<dhtVariant V>
+    DHT_sensor<V>::~DHT_sensor() {}
+
+    template<dhtVariant V>
+    const std::string DHT_sensor<V>::getType() {
+        return traits::name();
+    }
+
+    template<dhtVariant V>
+    bool DHT_sensor<V>::readData(float* humidity, float* temperature) {
+        dhtCapture capture;
+
+        // Send the start signal and measure the answer, then decode it once the pin is released
+        capture.count = backend->capturePulses(pin, traits::start(), capture.widths, DHT_PULSES, DHT_TIMEOUT);
+
+        dhtFrame frame = DHT_decoder::decode(capture);
+
+        if(!frame.valid)
+            return false;
+
+        *humidity = traits::humidity(frame.data);
+        *temperature = traits::temperature(frame.data);
+
+        return true;
+    }
+
+    template<dhtVariant V>
+    std::list<result> DHT_sensor<V>::getResults() {
+        std::lock_guard<std::mutex> l(lock);
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        std::list<result> results;
+
+        float fHumidity, fTemp;
+
+        // A sampling too close to the previous one is answered with the same measure, or not at all
+        if(now < lastSampling + std::chrono::milliseconds(traits::interval())) {
+            sensorException e("The sensor can't be sampled yet", sensorErrorCode::NOT_READY);
+            e.setRetry(lastSampling + std::chrono::milliseconds(traits::interval()));
+            throw e;
+        }
+
+        lastSampling = now;
+
+        if(readData(&fHumidity, &fTemp)) {
+            // Humidity
+            resultValue humidityValue;
+            humidityValue.f = fHumidity;
+
+            result humidity(resultType::HUMIDITY, humidityValue);
+
+            // Temperature
+            resultValue tempValue;
+            tempValue.f = fTemp;
+
+            result temp(resultType::TEMPERATURE, tempValue);
+
+            // Add to the list and return
+            results.push_back(humidity);
+            results.push_back(temp);
+
+            failures = 0;
+            lastGood = results;
+
+            return results;
+        }
+
+        // In some case, no data will be read. The next sampling usually allow to read new data from the sensor
+        if(++failures < DHT_RETRIES) {
+            sensorException e("Failed to read GPIO data", sensorErrorCode::INVALID_VALUE);
+            e.setRetry(now + std::chrono::milliseconds(traits::interval()));
+            throw e;
+        }
+
+        failures = 0;
+
+        // Too many failures : return the last good values if recent enough
+        if(lastGoodMaxAge > 0 && !lastGood.empty() &&
+           std::chrono::system_clock::now() - lastGood.front().getTime() <= std::chrono::milliseconds(lastGoodMaxAge)) {
+            for(result r : lastGood) {
+                r.setStale();
+                results.push_back(r);
+            }
+
+            return results;
+        }
+
+        // Error : no data could be read
+        throw sensorException("Failed to read GPIO data", sensorErrorCode::INVALID_VALUE);
+        return results;
+    }
+
+    template<dhtVariant V>
+    sensor* DHT_sensor<V>::create(int pin, const std::string& name, const sensorOptions& options) {
+        return (sensor*) new DHT_sensor<V>((unsigned) pin, name, options.bus, options.lastGood);
+    }
+
+    // Every supported variant
+    template class DHT_sensor<VARIANT_DHT11>;
+    template class DHT_sensor<VARIANT_DHT21>;
+    template class DHT_sensor<VARIANT_DHT22>;
+    template class DHT_sensor<VARIANT_AM2302>;
+
+}
@@ -0,0 +1,40 @@
+/**
+ * @file DHT_decoder.cc
+ * @brief Stateless decoding of the pulses answered by DHT sensors implementation
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#include "DHT_decoder.h"
+
+namespace sensor {
+
+    dhtFrame DHT_decoder::decode(const dhtCapture& capture) {
+        dhtFrame frame = { { 0, 0, 0, 0, 0 }, false, 0.0f };
+
+        if(capture.count < DHT_BITS || capture.count > DHT_PULSES)
+            return frame;
+
+        const unsigned* bits = capture.widths + capture.count - DHT_BITS;
+        float confidence = 1.0f;
+
+        // Shove each bit into the bytes, and keep the smallest margin to the threshold
+        for(unsigned i = 0; i < DHT_BITS; i++) {
+            unsigned width = bits[i];
+            bool one = width > DHT_BIT_THRESHOLD;
+            float margin = (one ? (float) (width - DHT_BIT_THRESHOLD) / (DHT_ONE_WIDTH - DHT_BIT_THRESHOLD)
+                                : (float) (DHT_BIT_THRESHOLD - width) / (DHT_BIT_THRESHOLD - DHT_ZERO_WIDTH));
+
+            frame.data[i / 8] = (uint8_t) ((frame.data[i / 8] << 1) | (one ? 1 : 0));
+
+            if(margin < confidence)
+                confidence = margin;
+        }
+
+        frame.confidence = confidence;
+        frame.valid = (frame.data[4] == (uint8_t) (frame.data[0] + frame.data[1] + frame.data[2] + frame.data[3]));
+
+        return frame;
+    }
+
+}
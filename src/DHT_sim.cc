@@ -0,0 +1,106 @@
+/**
+ * @file DHT_sim.cc
+ * @brief Simulated DHT11 and DHT22 devices implementation
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#include "DHT_sim.h"
+
+namespace sensor {
+
+    DHT_sim_device::DHT_sim_device(bool _dht11, unsigned _jitter):dht11(_dht11), jitter(_jitter) {
+        humidity = 45.5;
+        temperature = 21.3;
+        answers = 1;
+        failures = 0;
+        signals = 0;
+    }
+
+    DHT_sim_device::~DHT_sim_device() {}
+
+    void DHT_sim_device::setMeasure(float _humidity, float _temperature) {
+        humidity = _humidity;
+        temperature = _temperature;
+    }
+
+    void DHT_sim_device::setFailures(unsigned _answers, unsigned _failures) {
+        answers = _answers;
+        failures = _failures;
+    }
+
+    bool DHT_sim_device::level() {
+        return true; // Idle, pulled up
+    }
+
+    void DHT_sim_device::edge(gpioEdge* edges, size_t& count, size_t max, uint64_t& time, unsigned duration, bool rising) {
+        int shifted = (int) duration;
+
+        if(jitter > 0)
+            shifted += std::uniform_int_distribution<int>(-(int) jitter, (int) jitter)(random);
+
+        time += (uint64_t) std::max(shifted, 1) * 1000;
+
+        if(count < max) {
+            edges[count].timestamp = time;
+            edges[count].rising = rising;
+            count++;
+        }
+    }
+
+    size_t DHT_sim_device::answer(unsigned startLow, gpioEdge* edges, size_t max) {
+        uint8_t data[5];
+        uint64_t time = 0;
+        size_t count = 0;
+
+        // The start signal should last at least 18 ms for a DHT11, and 1 ms for a DHT22
+        if(startLow < (dht11 ? 18000u : 1000u))
+            return 0;
+
+        // Intermittent device, ignoring some of the start signals
+        if(failures > 0 && signals++ % (answers + failures) >= answers)
+            return 0;
+
+        if(dht11) {
+            data[0] = (uint8_t) humidity;
+            data[1] = 0;
+            data[2] = (uint8_t) temperature;
+            data[3] = 0;
+        } else {
+            unsigned h = (unsigned) (humidity * 10 + 0.5);
+            unsigned t = (unsigned) (std::abs(temperature) * 10 + 0.5);
+
+            data[0] = (uint8_t) (h >> 8);
+            data[1] = (uint8_t) h;
+            data[2] = (uint8_t) ((t >> 8) | (temperature < 0 ? 0x80 : 0));
+            data[3] = (uint8_t) t;
+        }
+
+        data[4] = (uint8_t) (data[0] + data[1] + data[2] + data[3]);
+
+        // Release, then acknowledgment
+        if(count < max) {
+            edges[count].timestamp = 0;
+            edges[count].rising = true;
+            count++;
+        }
+
+        edge(edges, count, max, time, 30, false);
+        edge(edges, count, max, time, 80, true);
+        edge(edges, count, max, time, 80, false);
+
+        // Measure, most significant bit first
+        for(unsigned i = 0; i < 40; i++) {
+            bool bit = (data[i / 8] >> (7 - i % 8)) & 1;
+
+            edge(edges, count, max, time, 50, true);
+            edge(edges, count, max, time, bit ? 70 : 26, false);
+        }
+
+        // End of the transfer
+        edge(edges, count, max, time, 50, true);
+
+        return count;
+    }
+
+}
@@ -9,7 +9,7 @@
 
 namespace sensor {
 
-    PIR_sensor::PIR_sensor(unsigned _pin, std::string _name):gpio_sensor(_pin, _name) {}
+    PIR_sensor::PIR_sensor(unsigned _pin, std::string _name, const std::string& _backend):gpio_sensor(_pin, _name, _backend) {}
 
     PIR_sensor::~PIR_sensor() {}
 
@@ -19,12 +19,10 @@ namespace sensor {
 
     int PIR_sensor::readData(int* piDetection) {
         // Prepare to read the pin
-        pinMode(getPin(), INPUT);
+        backend->setInput(pin, false);
 
         // Read the pin
-        uint8_t state = digitalRead(getPin());
-
-        if(state == HIGH)
+        if(backend->read(pin))
             *piDetection = 1;
         else
             *piDetection = 0;
@@ -49,8 +47,8 @@ namespace sensor {
         return results;
     }
 
-    sensor* PIR_sensor::create(int pin, const std::string& name) {
-        return (sensor*) new PIR_sensor((unsigned) pin, name);
+    sensor* PIR_sensor::create(int pin, const std::string& name, const sensorOptions& options) {
+        return (sensor*) new PIR_sensor((unsigned) pin, name, options.bus);
     }
 }
 
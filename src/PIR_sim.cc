@@ -0,0 +1,24 @@
+/**
+ * @file PIR_sim.cc
+ * @brief Simulated PIR device implementation
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#include "PIR_sim.h"
+
+namespace sensor {
+
+    PIR_sim_device::PIR_sim_device(unsigned _period, unsigned _high):period(_period), high(_high) {
+        creation = std::chrono::steady_clock::now();
+    }
+
+    PIR_sim_device::~PIR_sim_device() {}
+
+    bool PIR_sim_device::level() {
+        std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - creation;
+
+        return elapsed % period < high;
+    }
+
+}
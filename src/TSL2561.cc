@@ -7,124 +7,241 @@
 
 #include "TSL2561.h"
 
+#ifdef USE_GPIO
+#include "gpio_backend.h"
+#endif
+
+#include <thread>
+#include <algorithm>
+
 namespace sensor {
 
-    TSL2561_sensor::TSL2561_sensor(uint16_t deviceAddress, std::string _name):i2c_sensor(deviceAddress, _name) {}
+    TSL2561_sensor::TSL2561_sensor(uint16_t deviceAddress, std::string _name, const sensorOptions& options):i2c_sensor(deviceAddress, _name, options) {
+        package = (options.package == 0 ? PACKAGE_T : PACKAGE_CS);
+        interruptPin = options.interruptPin;
+        threshold = options.threshold;
+    }
 
-    TSL2561_sensor::~TSL2561_sensor() {};
+    TSL2561_sensor::~TSL2561_sensor() {
+        #ifdef USE_GPIO
+        if(interruptBackend)
+            gpio_backend::release(interruptBackend);
+        #endif
+    };
 
     const std::string TSL2561_sensor::getType() {
         return "TSL2561";
     }
 
     void TSL2561_sensor::prepare() {
-        writeRegister(TSL2561_CONTROL, 0x03);  // POWER UP
-        writeRegister(TSL2561_TIMING, 0x11);   // High Gain (16x), integration time of 101ms
-        writeRegister(TSL2561_INTERRUPT, 0x00);
+        if(interruptPin >= 0 && !interruptBackend)
+            setupInterrupt();
+
+        // Powered up, with the selected gain and integration time, and the interrupt enabled
+        // once its thresholds are set
+        configure(TSL2561_POWER_ON, (gain ? TSL2561_GAIN_16X : 0x0) | integration,
+                  armed ? TSL2561_INTERRUPT_LEVEL | TSL2561_PERSIST : 0x00);
     }
 
-    void TSL2561_sensor::readRawData(uint32_t* channel0, uint32_t* channel1) {
-        uint16_t CH0_LOW = readRegister(TSL2561_CHANNAL0L);
-        uint16_t CH0_HIGH = readRegister(TSL2561_CHANNAL0H);
+    void TSL2561_sensor::configure(uint8_t _control, uint8_t _timing, uint8_t _interrupt) {
+        i2c_transaction transaction(getDeviceAddress());
+
+        if(control != _control)
+            transaction.write(TSL2561_CONTROL, _control);
+        if(timing != _timing)
+            transaction.write(TSL2561_TIMING, _timing);
+        if(interrupt != _interrupt)
+            transaction.write(TSL2561_INTERRUPT, _interrupt);
+
+        if(transaction.getOperations().empty())
+            return; // Already configured
 
-        //read two bytes from registers 0x0E and 0x0F
-        uint16_t CH1_LOW = readRegister(TSL2561_CHANNAL1L);
-        uint16_t CH1_HIGH = readRegister(TSL2561_CHANNAL1H);
+        try {
+            execute(transaction);
+        } catch(sensorException& e) {
+            control = timing = interrupt = -1; // Unknown until written again
+            armed = false;
+            throw;
+        }
+
+        // Powering up or changing the timing restarts the integration
+        if(control != _control || timing != _timing)
+            integrationStart = std::chrono::steady_clock::now();
 
-        *channel0 = CH0_HIGH * 256 + CH0_LOW;
-        *channel1 = CH1_HIGH * 256 + CH1_LOW;
+        control = _control;
+        timing = _timing;
+        interrupt = _interrupt;
     }
 
-    uint32_t TSL2561_sensor::readData(uint16_t iGain, uint16_t tInt, uint16_t iType) {
-        uint32_t channel0 = 0x0, channel1 = 0x0;
+    // Integration times in microsecondes : 13.7ms, 101ms and 402ms, and their maximum counts
+    static const int integrationTimes[3] = { 13700, 101000, 402000 };
+    static const uint32_t maxCounts[3] = { 5047, 37177, 65535 };
 
-        // Read raw data
-        readRawData(&channel0, &channel1);
+    // Ranges, from the least to the most sensitive : gain, then integration time. The maximum count
+    // grows slower than the integration time, so e.g. 1x/402ms saturates at a higher light than 16x/13.7ms
+    static const uint8_t ranges[TSL2561_RANGES][2] = { { 0, 0 }, { 0, 1 }, { 1, 0 }, { 0, 2 }, { 1, 1 }, { 1, 2 } };
 
-        uint32_t chScale;
-        uint32_t ratio1;
-        uint32_t b = 0x0;
-        uint32_t m = 0x0;
-        uint32_t temp;
-        uint32_t lux;
+    void TSL2561_sensor::setRange(unsigned _range) {
+        range = _range;
+        gain = ranges[range][0];
+        integration = ranges[range][1];
+    }
 
-        switch (tInt) {
-            case 0:  // 13.7 msec
-                chScale = CHSCALE_TINT0;
-                break;
-            case 1: // 101 msec
-                chScale = CHSCALE_TINT1;
-                break;
-            default: // assume no scaling
-                chScale = (1 << CH_SCALE);
-                break;
+    uint32_t TSL2561_sensor::sensitivity(unsigned range) {
+        return (ranges[range][0] ? 16 : 1) * integrationTimes[ranges[range][1]];
+    }
+
+    bool TSL2561_sensor::saturatesAbove(unsigned range, unsigned other) {
+        return (uint64_t) maxCounts[ranges[range][1]] * sensitivity(other) > (uint64_t) maxCounts[ranges[other][1]] * sensitivity(range);
+    }
+
+    void TSL2561_sensor::adjustRange(uint32_t channel0) {
+        // Close to saturation, only the less sensitive ranges are considered, otherwise the more
+        // sensitive ones. Saturation not following the sensitivity, every one of them is checked
+        bool saturating = channel0 >= maxCounts[integration] * TSL2561_RANGE_HIGH / 100;
+        unsigned first = saturating ? 0 : range + 1;
+        unsigned last = saturating ? range : TSL2561_RANGES;
+        unsigned selected = saturating ? 0 : range;
+
+        for(unsigned r = first; r < last; r++) {
+            // Count expected with this range
+            uint64_t expected = (uint64_t) channel0 * sensitivity(r) / sensitivity(range);
+
+            if(expected <= maxCounts[ranges[r][1]] * TSL2561_RANGE_LOW / 100)
+                selected = r;
         }
 
-        if (!iGain)
-            chScale = chScale << 4; // scale 1X to 16X
-
-        // scale the channel values
-        channel0 = (channel0 * chScale) >> CH_SCALE;
-        channel1 = (channel1 * chScale) >> CH_SCALE;
-
-        ratio1 = 0;
-
-        if (channel0 != 0)
-            ratio1 = (channel1 << (RATIO_SCALE+1))/channel0;
-
-        // round the ratio value
-        uint16_t ratio = (ratio1 + 1) >> 1;
-
-        switch (iType) {
-            case 0: // T package
-                if (ratio <= K1T)
-                {b=B1T; m=M1T;}
-                else if (ratio <= K2T)
-                {b=B2T; m=M2T;}
-                else if (ratio <= K3T)
-                {b=B3T; m=M3T;}
-                else if (ratio <= K4T)
-                {b=B4T; m=M4T;}
-                else if (ratio <= K5T)
-                {b=B5T; m=M5T;}
-                else if (ratio <= K6T)
-                {b=B6T; m=M6T;}
-                else if (ratio <= K7T)
-                {b=B7T; m=M7T;}
-                else if (ratio > K8T)
-                {b=B8T; m=M8T;}
-                break;
-        case 1:// CS package
-                if (ratio <= K1C)
-                {b=B1C; m=M1C;}
-                else if (ratio <= K2C)
-                {b=B2C; m=M2C;}
-                else if (ratio <= K3C)
-                {b=B3C; m=M3C;}
-                else if (ratio <= K4C)
-                {b=B4C; m=M4C;}
-                else if (ratio <= K5C)
-                {b=B5C; m=M5C;}
-                else if (ratio <= K6C)
-                {b=B6C; m=M6C;}
-                else if (ratio <= K7C)
-                {b=B7C; m=M7C;}
+        if(selected != range)
+            setRange(selected);
+    }
+
+    void TSL2561_sensor::arm(uint32_t channel0) {
+        uint32_t window = std::max(channel0 * threshold / 100, 1u);
+        uint32_t low = channel0 > window ? channel0 - window : 0;
+        uint32_t high = std::min(channel0 + window, (uint32_t) 0xFFFF);
+
+        i2c_transaction transaction(getDeviceAddress());
+
+        // Thresholds, then the interrupt control written with the clear bit, which clears the
+        // pending interrupt
+        transaction.write(TSL2561_THRESHLOWLOW, low & 0xFF)
+                   .write(TSL2561_THRESHLOWHIGH, low >> 8)
+                   .write(TSL2561_THRESHHIGHLOW, high & 0xFF)
+                   .write(TSL2561_THRESHHIGHHIGH, high >> 8)
+                   .write(TSL2561_INTERRUPT | TSL2561_CLEAR, TSL2561_INTERRUPT_LEVEL | TSL2561_PERSIST);
+
+        try {
+            execute(transaction);
+        } catch(sensorException& e) {
+            control = timing = interrupt = -1;
+            armed = false;
+            throw;
         }
 
-        temp = ((channel0*b) - (channel1*m));
-        temp += (1 << (LUX_SCALE-1));
+        interrupt = TSL2561_INTERRUPT_LEVEL | TSL2561_PERSIST;
+        armed = true;
+    }
 
-        // strip off fractional portion
-        lux = temp >> LUX_SCALE;
+    void TSL2561_sensor::setupInterrupt() {
+        #ifdef USE_GPIO
+        gpio_backend* backend = gpio_backend::acquire("");
 
-        return lux;
+        // The interrupt line is an open drain, active low
+        try {
+            backend->setInput((unsigned) interruptPin, true);
+        } catch(sensorException& e) {
+            gpio_backend::release(backend);
+            throw;
+        }
+
+        interruptBackend = backend;
+        #else
+        throw sensorException("The TSL2561 event mode requires the GPIO support", sensorErrorCode::GPIO_ERROR);
+        #endif
+    }
+
+    bool TSL2561_sensor::interrupted() {
+        #ifdef USE_GPIO
+        // The interrupt is a level, held until cleared, so no event can be missed between two fetches
+        return !interruptBackend->read((unsigned) interruptPin);
+        #else
+        return true;
+        #endif
+    }
+
+    void TSL2561_sensor::waitIntegration() {
+        // The channels are updated at the end of each integration, so a complete one must end
+        // after the last read. Waiting a whole integration guarantees it
+        std::chrono::steady_clock::time_point ready = std::max(integrationStart, lastRead) +
+            std::chrono::microseconds(integrationTimes[integration] * (100 + TSL2561_INTEGRATION_MARGIN) / 100);
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+        if(now < ready)
+            std::this_thread::sleep_for(ready - now);
+    }
+
+    void TSL2561_sensor::readRawData(uint32_t* channel0, uint32_t* channel1) {
+        uint8_t buffer[4];
+
+        // Read the four bytes from registers 0x0C to 0x0F in a single combined read, the register
+        // address being incremented by the sensor. Both channels then come from the same integration
+        readRegisterBlock(TSL2561_CHANNAL0L, buffer, 4);
+
+        *channel0 = buffer[1] * 256 + buffer[0];
+        *channel1 = buffer[3] * 256 + buffer[2];
     }
 
     std::list<result> TSL2561_sensor::getResults() {
         std::list<result> results;
 
-        // Read the result from the sensor
-        uint32_t lux = readData(0, 0, 1);
+        // In event mode, only read the sensor when the light left the thresholds
+        if(interruptPin >= 0 && armed && !interrupted())
+            return results;
+
+        uint32_t channel0, channel1;
+
+        // Read the result from the sensor, once fresh
+        while(true) {
+            waitIntegration();
+
+            try {
+                readRawData(&channel0, &channel1);
+            } catch(sensorException& e) {
+                control = timing = interrupt = -1; // The sensor may have been reset
+                armed = false;
+                throw;
+            }
+
+            lastRead = std::chrono::steady_clock::now();
+
+            if(channel0 < maxCounts[integration] && channel1 < maxCounts[integration])
+                break;
+
+            // Saturated, the reading is meaningless : read again with the closest less sensitive
+            // range saturating at a higher light (the least sensitive one saturates last)
+            if(range == 0)
+                throw sensorException("TSL2561 saturated, the light is too intense", sensorErrorCode::INVALID_VALUE);
+
+            unsigned next = range - 1;
+
+            while(next > 0 && !saturatesAbove(next, range))
+                next--;
+
+            setRange(next);
+            prepare();
+        }
+
+        uint32_t lux = TSL2561_lux::compute(package, (tsl2561Timing) integration, gain, channel0, channel1);
+
+        // Range of the next reading
+        unsigned previous = range;
+        adjustRange(channel0);
+
+        // In event mode, set the thresholds around the reading, with the range of the next one
+        if(interruptPin >= 0) {
+            prepare();
+            arm((uint64_t) channel0 * sensitivity(range) / sensitivity(previous));
+        }
 
         // Init the data
         resultValue luxValue;
@@ -137,8 +254,8 @@ namespace sensor {
         return results;
     }
 
-    sensor* TSL2561_sensor::create(int address, const std::string& name) {
-        return (sensor*) new TSL2561_sensor((uint16_t) address, name);
+    sensor* TSL2561_sensor::create(int address, const std::string& name, const sensorOptions& options) {
+        return (sensor*) new TSL2561_sensor((uint16_t) address, name, options);
     }
 }
 
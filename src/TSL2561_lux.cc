@@ -0,0 +1,38 @@
+/**
+ * @file TSL2561_lux.cc
+ * @brief Stateless conversion of the raw TSL2561 channels to lux implementation
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#include "TSL2561_lux.h"
+
+namespace sensor {
+
+    constexpr tsl2561Segment tsl2561Coefficients<PACKAGE_T>::segments[TSL2561_SEGMENTS];
+    constexpr tsl2561Segment tsl2561Coefficients<PACKAGE_CS>::segments[TSL2561_SEGMENTS];
+
+    typedef uint32_t (*luxFunction)(uint32_t, uint32_t, uint16_t);
+    typedef void (*luxBatchFunction)(size_t, const uint32_t*, const uint32_t*, uint16_t, uint32_t*);
+
+    // Specialized conversions, by package and integration time
+    static const luxFunction luxFunctions[2][3] = {
+        { TSL2561_lux::lux<PACKAGE_T, TIMING_13MS>, TSL2561_lux::lux<PACKAGE_T, TIMING_101MS>, TSL2561_lux::lux<PACKAGE_T, TIMING_402MS> },
+        { TSL2561_lux::lux<PACKAGE_CS, TIMING_13MS>, TSL2561_lux::lux<PACKAGE_CS, TIMING_101MS>, TSL2561_lux::lux<PACKAGE_CS, TIMING_402MS> }
+    };
+
+    static const luxBatchFunction luxBatchFunctions[2][3] = {
+        { TSL2561_lux::lux<PACKAGE_T, TIMING_13MS>, TSL2561_lux::lux<PACKAGE_T, TIMING_101MS>, TSL2561_lux::lux<PACKAGE_T, TIMING_402MS> },
+        { TSL2561_lux::lux<PACKAGE_CS, TIMING_13MS>, TSL2561_lux::lux<PACKAGE_CS, TIMING_101MS>, TSL2561_lux::lux<PACKAGE_CS, TIMING_402MS> }
+    };
+
+    uint32_t TSL2561_lux::compute(tsl2561Package package, tsl2561Timing timing, uint16_t gain, uint32_t channel0, uint32_t channel1) {
+        return luxFunctions[package][timing](channel0, channel1, gain);
+    }
+
+    void TSL2561_lux::compute(tsl2561Package package, tsl2561Timing timing, uint16_t gain, size_t count,
+                              const uint32_t* channel0, const uint32_t* channel1, uint32_t* lux) {
+        luxBatchFunctions[package][timing](count, channel0, channel1, gain, lux);
+    }
+
+}
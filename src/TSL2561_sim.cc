@@ -0,0 +1,81 @@
+/**
+ * @file TSL2561_sim.cc
+ * @brief Simulated TSL2561 device implementation
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#include "TSL2561_sim.h"
+
+namespace sensor {
+
+    // Integration times in microseconds, scale of the counts (x 1000) and maximum counts, by timing
+    static const int integrationTimes[4] = { 13700, 101000, 402000, 402000 };
+    static const uint32_t integrationScales[4] = { 34, 252, 1000, 1000 };
+    static const uint32_t integrationMaximums[4] = { 5047, 37177, 65535, 65535 };
+
+    TSL2561_sim_device::TSL2561_sim_device() {
+        memset(registers, 0x0, sizeof(registers));
+
+        registers[0x1] = 0x02; // 1x gain, 402 ms
+        registers[0xA] = 0x50; // Part number and revision
+
+        broadband = 1000;
+        infrared = 300;
+    }
+
+    TSL2561_sim_device::~TSL2561_sim_device() {}
+
+    void TSL2561_sim_device::setIrradiance(uint32_t _broadband, uint32_t _infrared) {
+        broadband = _broadband;
+        infrared = _infrared;
+    }
+
+    void TSL2561_sim_device::update() {
+        if((registers[0x0] & 0x03) != 0x03)
+            return; // Powered down
+
+        int timing = registers[0x1] & 0x03;
+
+        if(std::chrono::steady_clock::now() - integrationStart < std::chrono::microseconds(integrationTimes[timing]))
+            return; // First integration not completed
+
+        uint32_t scale = integrationScales[timing] * ((registers[0x1] & 0x10) ? 16 : 1);
+        uint32_t channel0 = std::min(broadband * scale / 1000, integrationMaximums[timing]);
+        uint32_t channel1 = std::min(infrared * scale / 1000, integrationMaximums[timing]);
+
+        registers[0xC] = channel0 & 0xFF;
+        registers[0xD] = channel0 >> 8;
+        registers[0xE] = channel1 & 0xFF;
+        registers[0xF] = channel1 >> 8;
+    }
+
+    void TSL2561_sim_device::read(uint8_t command, uint8_t* buffer, size_t len) {
+        update();
+
+        for(size_t i = 0; i < len; i++)
+            buffer[i] = registers[(command + i) & 0x0F];
+    }
+
+    void TSL2561_sim_device::write(uint8_t command, uint8_t value) {
+        if(!(command & 0x80))
+            return; // Not a command
+
+        uint8_t reg = command & 0x0F;
+
+        update();
+
+        // Powering up, or changing the timing, restarts the integrations
+        if((reg == 0x0 && (value & 0x03) == 0x03 && (registers[0x0] & 0x03) != 0x03) ||
+           (reg == 0x1 && value != registers[0x1]))
+            integrationStart = std::chrono::steady_clock::now();
+
+        // Powering down clears the channels
+        if(reg == 0x0 && (value & 0x03) != 0x03)
+            memset(registers + 0xC, 0x0, 4);
+
+        if(reg != 0xA)
+            registers[reg] = value;
+    }
+
+}
@@ -0,0 +1,130 @@
+/**
+ * @file gpio_backend.cc
+ * @brief Creation and registry of the GPIO backends
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#include "gpio_backend.h"
+#include "gpio_chardev.h"
+#include "gpio_sim_backend.h"
+#ifdef USE_WIRINGPI
+#include "gpio_wiringpi_backend.h"
+#endif
+#include "DHT_sim.h"
+#include "PIR_sim.h"
+
+namespace sensor {
+
+    std::map<std::string, gpio_backend*> gpio_backend::backends;
+    std::mutex gpio_backend::registryLock;
+
+    // BCM number of each wiringPi pin, on every board since the revision 2 of the model B
+    static const int pinLines[] = {
+        17, 18, 27, 22, 23, 24, 25,  4,  2,  3,  8,  7, 10,  9, 11, 14,
+        15, 28, 29, 30, 31,  5,  6, 13, 19, 26, 12, 16, 20, 21,  0,  1
+    };
+
+    gpio_backend* gpio_backend::create(const std::string& name) {
+        if(name == "sim" || name.compare(0, 4, "sim:") == 0) {
+            // Simulated pins, with a DHT11, a PIR, an intermittent DHT22 and a DHT22 on the pins 0, 1, 2 and 7
+            unsigned jitter = 0;
+
+            if(name.size() > 4 && name[3] == ':')
+                jitter = (unsigned) strtoul(name.c_str() + 4, NULL, 10);
+
+            gpio_sim_backend* backend = new gpio_sim_backend();
+            backend->attach(0, new DHT_sim_device(true, jitter));
+            backend->attach(1, new PIR_sim_device());
+
+            // Answering once every 6 start signals, i.e. failing more times in a row than the DHT retries
+            DHT_sim_device* intermittent = new DHT_sim_device(false, jitter);
+            intermittent->setFailures(1, 5);
+            backend->attach(2, intermittent);
+
+            backend->attach(7, new DHT_sim_device(false, jitter));
+
+            return backend;
+        }
+
+        if(name == "wiringpi") {
+            #ifdef USE_WIRINGPI
+            return new gpio_wiringpi_backend();
+            #else
+            throw sensorException("The wiringPi support is not compiled in", sensorErrorCode::GPIO_ERROR);
+            #endif
+        }
+
+        return new gpio_chardev_backend(name);
+    }
+
+    gpio_backend* gpio_backend::acquire(const std::string& name) {
+        std::lock_guard<std::mutex> l(registryLock);
+
+        if(!name.empty())
+            return reference(name);
+
+        // Default : the GPIO chip, registered under its path, or wiringPi if it can't be used (old kernel, no access, ...)
+        #ifdef USE_WIRINGPI
+        try {
+            return reference(GPIO_CHIP_FILE);
+        } catch(sensorException& e) {
+            return reference("wiringpi");
+        }
+        #else
+        return reference(GPIO_CHIP_FILE);
+        #endif
+    }
+
+    gpio_backend* gpio_backend::reference(const std::string& name) {
+        gpio_backend* backend;
+        auto it = backends.find(name);
+
+        if(it == backends.end()) {
+            backend = create(name);
+            backend->name = name;
+            backend->references = 0;
+            backends[name] = backend;
+        } else
+            backend = it->second;
+
+        backend->references++;
+        return backend;
+    }
+
+    void gpio_backend::release(gpio_backend* backend) {
+        std::lock_guard<std::mutex> l(registryLock);
+
+        if(--backend->references > 0)
+            return;
+
+        backends.erase(backend->name);
+        delete backend;
+    }
+
+    unsigned gpio_backend::pinToLine(unsigned pin) {
+        if(pin >= sizeof(pinLines) / sizeof(pinLines[0]))
+            throw sensorException(fmt::format("Invalid GPIO pin {0}", pin), sensorErrorCode::GPIO_ERROR);
+
+        return (unsigned) pinLines[pin];
+    }
+
+    unsigned gpio_backend::pulseWidths(const gpioEdge* edges, size_t count, unsigned* widths, unsigned max) {
+        uint64_t rising = 0;
+        bool high = false;
+        unsigned pulses = 0;
+
+        for(size_t i = 0; i < count && pulses < max; i++) {
+            if(edges[i].rising) {
+                rising = edges[i].timestamp;
+                high = true;
+            } else if(high) {
+                widths[pulses++] = (unsigned) ((edges[i].timestamp - rising) / 1000);
+                high = false;
+            }
+        }
+
+        return pulses;
+    }
+
+}
@@ -0,0 +1,230 @@
+/**
+ * @file gpio_chardev.cc
+ * @brief GPIO lines requested through the Linux GPIO character device, and the GPIO backend
+ * using them
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#include "gpio_chardev.h"
+
+namespace sensor {
+
+#ifdef GPIO_V2_GET_LINE_IOCTL
+
+    gpio_chardev::gpio_chardev(const std::string& _path, unsigned _offset):path(_path), offset(_offset) {
+        struct gpio_v2_line_request request;
+        int chip;
+
+        if((chip = open(path.c_str(), O_RDWR | O_CLOEXEC)) < 0)
+            throw sensorException(fmt::format("Failed to open the GPIO chip : {0}", strerror(errno)), sensorErrorCode::FILE_ERROR, errno);
+
+        memset(&request, 0, sizeof(request));
+        request.offsets[0] = offset;
+        request.num_lines = 1;
+        request.event_buffer_size = GPIO_EVENT_BUFFER;
+        request.config.flags = GPIO_V2_LINE_FLAG_INPUT;
+        strncpy(request.consumer, GPIO_CONSUMER, sizeof(request.consumer) - 1);
+
+        if(ioctl(chip, GPIO_V2_GET_LINE_IOCTL, &request) < 0) {
+            int error = errno;
+            close(chip);
+            throw sensorException(fmt::format("Failed to request the GPIO line {0} : {1}", offset, strerror(error)), sensorErrorCode::GPIO_ERROR, error);
+        }
+
+        // The line stays requested once the chip is closed
+        close(chip);
+        fd = request.fd;
+    }
+
+    void gpio_chardev::configure(uint64_t flags, bool output, bool value) {
+        struct gpio_v2_line_config config;
+
+        memset(&config, 0, sizeof(config));
+        config.flags = flags;
+
+        if(output) {
+            config.num_attrs = 1;
+            config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+            config.attrs[0].attr.values = value ? 1 : 0;
+            config.attrs[0].mask = 1;
+        }
+
+        if(ioctl(fd, GPIO_V2_LINE_SET_CONFIG_IOCTL, &config) < 0)
+            throw sensorException(fmt::format("Failed to configure the GPIO line {0} : {1}", offset, strerror(errno)), sensorErrorCode::GPIO_ERROR, errno);
+    }
+
+    void gpio_chardev::setOutput(bool value) {
+        configure(GPIO_V2_LINE_FLAG_OUTPUT, true, value);
+    }
+
+    void gpio_chardev::setInput(bool edges, bool pullUp) {
+        uint64_t flags = GPIO_V2_LINE_FLAG_INPUT | (pullUp ? GPIO_V2_LINE_FLAG_BIAS_PULL_UP : 0);
+
+        if(edges) {
+            configure(flags | GPIO_V2_LINE_FLAG_EDGE_RISING | GPIO_V2_LINE_FLAG_EDGE_FALLING, false, false);
+            return;
+        }
+
+        configure(flags, false, false);
+
+        // Discard the edges left, so they aren't mistaken for the next ones
+        struct gpio_v2_line_event events[16];
+        struct pollfd pending = { fd, POLLIN, 0 };
+
+        while(poll(&pending, 1, 0) > 0 && read(fd, events, sizeof(events)) > 0);
+    }
+
+    bool gpio_chardev::getValue() {
+        struct gpio_v2_line_values values;
+
+        memset(&values, 0, sizeof(values));
+        values.mask = 1;
+
+        if(ioctl(fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &values) < 0)
+            throw sensorException(fmt::format("Failed to read the GPIO line {0} : {1}", offset, strerror(errno)), sensorErrorCode::GPIO_ERROR, errno);
+
+        return (values.bits & 1) != 0;
+    }
+
+    size_t gpio_chardev::readEdges(gpioEdge* edges, size_t max, unsigned timeout) {
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(timeout);
+        struct gpio_v2_line_event events[16];
+        size_t count = 0;
+
+        while(count < max) {
+            std::chrono::steady_clock::duration left = deadline - std::chrono::steady_clock::now();
+
+            if(left.count() <= 0)
+                break;
+
+            // Sleep until the next edges, the kernel queues them in the meantime
+            struct pollfd pending = { fd, POLLIN, 0 };
+            struct timespec wait;
+            uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(left).count();
+
+            wait.tv_sec = ns / 1000000000;
+            wait.tv_nsec = ns % 1000000000;
+
+            int ready = ppoll(&pending, 1, &wait, NULL);
+
+            if(ready < 0 && errno == EINTR)
+                continue;
+            else if(ready < 0)
+                throw sensorException(fmt::format("Failed to wait for the GPIO line {0} : {1}", offset, strerror(errno)), sensorErrorCode::GPIO_ERROR, errno);
+            else if(ready == 0)
+                break; // Timeout
+
+            size_t wanted = std::min(max - count, sizeof(events) / sizeof(events[0]));
+            ssize_t len = read(fd, events, wanted * sizeof(events[0]));
+
+            if(len < 0 && errno == EINTR)
+                continue;
+            else if(len < 0)
+                throw sensorException(fmt::format("Failed to read the GPIO line {0} : {1}", offset, strerror(errno)), sensorErrorCode::GPIO_ERROR, errno);
+
+            for(size_t i = 0; i < (size_t) len / sizeof(events[0]); i++) {
+                edges[count].timestamp = events[i].timestamp_ns;
+                edges[count].rising = (events[i].id == GPIO_V2_LINE_EVENT_RISING_EDGE);
+                count++;
+            }
+        }
+
+        return count;
+    }
+
+#else
+
+    // Kernel headers without the v2 uAPI (before Linux 5.10) : the line can't be requested, and
+    // the users fall back to something else
+    gpio_chardev::gpio_chardev(const std::string& _path, unsigned _offset):path(_path), offset(_offset) {
+        throw sensorException("The GPIO character device v2 is not supported", sensorErrorCode::GPIO_ERROR, ENOTSUP);
+    }
+
+    void gpio_chardev::configure(uint64_t, bool, bool) {}
+
+    void gpio_chardev::setOutput(bool) {}
+
+    void gpio_chardev::setInput(bool, bool) {}
+
+    bool gpio_chardev::getValue() {
+        return false;
+    }
+
+    size_t gpio_chardev::readEdges(gpioEdge*, size_t, unsigned) {
+        return 0;
+    }
+
+#endif
+
+    gpio_chardev::~gpio_chardev() {
+        close(fd);
+    }
+
+    gpio_chardev_backend::gpio_chardev_backend(const std::string& _path):path(_path) {
+        // Check the chip and the uAPI now, to let the caller use something else
+        #ifdef GPIO_V2_GET_LINE_IOCTL
+        struct gpiochip_info info;
+        int chip;
+
+        if((chip = open(path.c_str(), O_RDWR | O_CLOEXEC)) < 0)
+            throw sensorException(fmt::format("Failed to open the GPIO chip : {0}", strerror(errno)), sensorErrorCode::FILE_ERROR, errno);
+
+        if(ioctl(chip, GPIO_GET_CHIPINFO_IOCTL, &info) < 0) {
+            int error = errno;
+            close(chip);
+            throw sensorException(fmt::format("{0} is not a GPIO chip : {1}", path, strerror(error)), sensorErrorCode::GPIO_ERROR, error);
+        }
+
+        close(chip);
+        #else
+        throw sensorException("The GPIO character device v2 is not supported", sensorErrorCode::GPIO_ERROR, ENOTSUP);
+        #endif
+    }
+
+    gpio_chardev_backend::~gpio_chardev_backend() {
+        for(auto& line : lines)
+            delete line.second;
+    }
+
+    gpio_chardev* gpio_chardev_backend::getLine(unsigned pin) {
+        std::lock_guard<std::mutex> l(linesLock);
+        auto it = lines.find(pin);
+
+        if(it != lines.end())
+            return it->second;
+
+        gpio_chardev* line = new gpio_chardev(path, pinToLine(pin));
+        lines[pin] = line;
+
+        return line;
+    }
+
+    void gpio_chardev_backend::setInput(unsigned pin, bool pullUp) {
+        getLine(pin)->setInput(false, pullUp);
+    }
+
+    void gpio_chardev_backend::setOutput(unsigned pin, bool value) {
+        getLine(pin)->setOutput(value);
+    }
+
+    bool gpio_chardev_backend::read(unsigned pin) {
+        return getLine(pin)->getValue();
+    }
+
+    unsigned gpio_chardev_backend::capturePulses(unsigned pin, unsigned startLow, unsigned* widths, unsigned max, unsigned timeout) {
+        gpio_chardev* line = getLine(pin);
+        std::vector<gpioEdge> edges(2 * max + 1);
+
+        // A start pulse, then every edge of the answer is timestamped by the kernel while waiting
+        line->setOutput(false);
+        std::this_thread::sleep_for(std::chrono::microseconds(startLow));
+        line->setInput(true);
+
+        size_t count = line->readEdges(edges.data(), edges.size(), timeout);
+        line->setInput(false);
+
+        return pulseWidths(edges.data(), count, widths, max);
+    }
+
+}
@@ -0,0 +1,68 @@
+/**
+ * @file gpio_sim_backend.cc
+ * @brief Simulated GPIO backend implementation
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#include "gpio_sim_backend.h"
+
+namespace sensor {
+
+    gpio_sim_backend::gpio_sim_backend() {}
+
+    gpio_sim_backend::~gpio_sim_backend() {
+        for(auto& device : devices)
+            delete device.second;
+    }
+
+    void gpio_sim_backend::attach(unsigned pin, gpio_sim_device* device) {
+        std::lock_guard<std::mutex> l(lock);
+
+        delete devices[pin];
+        devices[pin] = device;
+    }
+
+    void gpio_sim_backend::setInput(unsigned pin, bool) {
+        std::lock_guard<std::mutex> l(lock);
+        outputs.erase(pin);
+    }
+
+    void gpio_sim_backend::setOutput(unsigned pin, bool value) {
+        std::lock_guard<std::mutex> l(lock);
+        outputs[pin] = value;
+    }
+
+    bool gpio_sim_backend::read(unsigned pin) {
+        std::lock_guard<std::mutex> l(lock);
+
+        auto output = outputs.find(pin);
+        if(output != outputs.end())
+            return output->second;
+
+        auto device = devices.find(pin);
+        if(device != devices.end())
+            return device->second->level();
+
+        return true; // Pulled up
+    }
+
+    unsigned gpio_sim_backend::capturePulses(unsigned pin, unsigned startLow, unsigned* widths, unsigned max, unsigned timeout) {
+        std::lock_guard<std::mutex> l(lock);
+        std::vector<gpioEdge> edges(2 * max + 1);
+        size_t count = 0;
+
+        outputs.erase(pin); // Released after the start signal
+
+        auto device = devices.find(pin);
+        if(device != devices.end())
+            count = device->second->answer(startLow, edges.data(), edges.size());
+
+        // Only keep what would be captured before the timeout
+        while(count > 0 && edges[count - 1].timestamp > (uint64_t) timeout * 1000)
+            count--;
+
+        return pulseWidths(edges.data(), count, widths, max);
+    }
+
+}
@@ -0,0 +1,100 @@
+/**
+ * @file gpio_wiringpi_backend.cc
+ * @brief GPIO backend using wiringPi implementation
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#include "gpio_wiringpi_backend.h"
+
+namespace sensor {
+
+    bool gpio_wiringpi_backend::isGPIOInitialized = false;
+
+    gpio_wiringpi_backend::gpio_wiringpi_backend() {
+        if(!isGPIOInitialized) {
+            if(wiringPiSetup() < 0) {
+                throw sensorException("Failed to init WiringPi", sensorErrorCode::GPIO_ERROR);
+            } else {
+                isGPIOInitialized = true;
+            }
+        }
+    }
+
+    gpio_wiringpi_backend::~gpio_wiringpi_backend() {}
+
+    void gpio_wiringpi_backend::setInput(unsigned pin, bool pullUp) {
+        pinMode(pin, INPUT);
+
+        if(pullUp)
+            pullUpDnControl(pin, PUD_UP);
+    }
+
+    void gpio_wiringpi_backend::setOutput(unsigned pin, bool value) {
+        pinMode(pin, OUTPUT);
+        digitalWrite(pin, value ? HIGH : LOW);
+    }
+
+    bool gpio_wiringpi_backend::read(unsigned pin) {
+        return digitalRead(pin) == HIGH;
+    }
+
+    unsigned gpio_wiringpi_backend::capturePulses(unsigned pin, unsigned startLow, unsigned* widths, unsigned max, unsigned) {
+        uint8_t laststate = HIGH;
+        unsigned count = 0;
+
+        pinMode(pin, OUTPUT);
+        digitalWrite(pin, LOW);
+        delayMicroseconds(startLow);
+
+        digitalWrite(pin, HIGH);
+        delayMicroseconds(40);
+
+        pinMode(pin, INPUT);
+
+        // Poll the pin, until a state lasts longer than getTime() measures
+        while(count < max) {
+            int timer = getTime(pin, &laststate);
+
+            if(timer < 0)
+                break;
+
+            // The pin went low, ending a high pulse
+            if(laststate == LOW)
+                widths[count++] = (unsigned) timer;
+        }
+
+        return count;
+    }
+
+    double gpio_wiringpi_backend::timeDiff(struct timeval x , struct timeval y) {
+        double x_ms , y_ms , diff;
+
+        x_ms = (double)x.tv_sec*1000000 + (double)x.tv_usec;
+        y_ms = (double)y.tv_sec*1000000 + (double)y.tv_usec;
+
+        diff = (double)y_ms - (double)x_ms;
+
+        return diff;
+    }
+
+    int gpio_wiringpi_backend::getTime(unsigned pin, uint8_t* laststate) {
+        struct timeval start, stop;
+        int counter = 0;
+        gettimeofday(&start, NULL);
+
+        while (digitalRead(pin) == *laststate) {
+            delayMicroseconds(1);
+            counter++;
+            if (counter == 255) {
+                return -1;
+            }
+        }
+
+        gettimeofday(&stop, NULL);
+        *laststate = digitalRead(pin);
+
+        return (int) timeDiff(start, stop);
+    }
+
+}
@@ -0,0 +1,323 @@
+/**
+ * @file i2c_bus.cc
+ * @brief Shared handle on an I2C bus implementation
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#include "i2c_bus.h"
+
+namespace sensor {
+
+    std::map<std::string, i2c_bus*> i2c_bus::buses;
+    std::mutex i2c_bus::registryLock;
+
+    i2c_bus::i2c_bus(const std::string& _path):path(_path) {
+        transport = i2c_transport::create(path);
+        references = 0;
+
+        stopping = false;
+        creation = std::chrono::steady_clock::now();
+
+        // Start the executor
+        worker = std::thread(&i2c_bus::run, this);
+    }
+
+    i2c_bus::~i2c_bus() {
+        // Stop the executor, once every pending transaction is performed
+        {
+            std::lock_guard<std::mutex> l(queueLock);
+            stopping = true;
+        }
+        queueCondition.notify_all();
+        worker.join();
+
+        delete transport;
+    }
+
+    i2c_bus* i2c_bus::acquire(const std::string& path) {
+        std::lock_guard<std::mutex> l(registryLock);
+
+        i2c_bus* bus;
+        auto it = buses.find(path);
+
+        if(it == buses.end()) {
+            bus = new i2c_bus(path);
+            buses[path] = bus;
+        } else
+            bus = it->second;
+
+        bus->references++;
+        return bus;
+    }
+
+    void i2c_bus::release(i2c_bus* bus) {
+        std::lock_guard<std::mutex> l(registryLock);
+
+        if(--bus->references > 0)
+            return;
+
+        buses.erase(bus->path);
+        delete bus;
+    }
+
+    const std::string& i2c_bus::getPath() {
+        return path;
+    }
+
+    std::future<void> i2c_bus::submit(i2c_transaction& transaction) {
+        std::future<void> done;
+
+        {
+            std::lock_guard<std::mutex> l(queueLock);
+
+            queue.emplace_back();
+            queue.back().transaction = &transaction;
+            queue.back().submission = std::chrono::steady_clock::now();
+            done = queue.back().done.get_future();
+        }
+        queueCondition.notify_one();
+
+        return done;
+    }
+
+    void i2c_bus::execute(i2c_transaction& transaction) {
+        submit(transaction).get();
+    }
+
+    void i2c_bus::addMux(int mux) {
+        std::lock_guard<std::mutex> l(queueLock);
+        muxes.insert(mux);
+    }
+
+    double i2c_bus::getUtilization() {
+        std::lock_guard<std::mutex> l(statsLock);
+        std::chrono::steady_clock::duration uptime = std::chrono::steady_clock::now() - creation;
+
+        if(uptime.count() <= 0)
+            return 0.0;
+
+        return (double) std::chrono::duration_cast<std::chrono::steady_clock::duration>(stats.busyTime).count() / (double) uptime.count();
+    }
+
+    std::list<i2cBusStats> i2c_bus::getAllStats() {
+        std::lock_guard<std::mutex> l(registryLock);
+        std::list<i2cBusStats> all;
+
+        for(auto& it : buses) {
+            i2c_bus* bus = it.second;
+            i2cBusStats busStats;
+
+            busStats.path = bus->path;
+            busStats.utilization = bus->getUtilization();
+
+            std::lock_guard<std::mutex> sl(bus->statsLock);
+            busStats.stats = bus->stats;
+
+            for(auto& device : bus->devices) {
+                i2cDeviceStats deviceStats;
+
+                deviceStats.mux = std::get<0>(device.first);
+                deviceStats.channel = std::get<1>(device.first);
+                deviceStats.address = (uint16_t) std::get<2>(device.first);
+                deviceStats.state = device.second.health.state;
+                deviceStats.stats = device.second.stats;
+
+                busStats.devices.push_back(deviceStats);
+            }
+
+            all.push_back(busStats);
+        }
+
+        return all;
+    }
+
+    void i2c_bus::run() {
+        std::unique_lock<std::mutex> l(queueLock);
+
+        while(true) {
+            queueCondition.wait(l, [this]() { return stopping || !queue.empty(); });
+
+            if(queue.empty())
+                return; // Stopping, and nothing left to do
+
+            // Take everything pending, and group it by multiplexer channel then by slave address
+            // to limit the channel switches and the device selections. The sort is stable, so
+            // each device keeps its own order
+            std::list<i2cPendingTransaction> batch;
+            batch.swap(queue);
+
+            // The multiplexers declared since are unknown : a channel may still be enabled by a
+            // previous process, or since a reset without power cycle
+            for(int mux : muxes)
+                muxControls.emplace(mux, -1);
+
+            muxes.clear();
+            l.unlock();
+
+            batch.sort([](i2cPendingTransaction& a, i2cPendingTransaction& b) {
+                if(a.transaction->getMux() != b.transaction->getMux())
+                    return a.transaction->getMux() < b.transaction->getMux();
+                if(a.transaction->getChannel() != b.transaction->getChannel())
+                    return a.transaction->getChannel() < b.transaction->getChannel();
+                return a.transaction->getAddress() < b.transaction->getAddress();
+            });
+
+            for(i2cPendingTransaction& pending : batch) {
+                try {
+                    perform(pending);
+                    pending.done.set_value();
+                } catch(...) {
+                    pending.done.set_exception(std::current_exception());
+                }
+            }
+
+            l.lock();
+        }
+    }
+
+    void i2c_bus::route(i2c_transaction& transaction) {
+        // A transaction sent to a multiplexer itself (e.g. by a scan) may change its control byte
+        auto target = muxControls.find(transaction.getAddress());
+
+        if(target != muxControls.end() && transaction.getMux() < 0)
+            target->second = -1;
+
+        if(transaction.getMux() < 0)
+            return; // Not behind a multiplexer
+
+        uint8_t control = 1 << transaction.getChannel();
+
+        // Only one multiplexer may have a channel enabled, in case the same
+        // addresses are used behind several ones
+        for(auto& mux : muxControls) {
+            if(mux.first != transaction.getMux() && mux.second != 0) {
+                mux.second = -1; // Unknown, until written
+                transport->sendByte(mux.first, 0x0);
+                mux.second = 0;
+            }
+        }
+
+        // Only switch the channel if needed
+        auto it = muxControls.find(transaction.getMux());
+
+        if(it != muxControls.end() && it->second == control)
+            return;
+
+        muxControls[transaction.getMux()] = -1; // Unknown, until written
+        transport->sendByte(transaction.getMux(), control);
+        muxControls[transaction.getMux()] = control;
+    }
+
+    void i2c_bus::account(i2cStats& target, i2cPendingTransaction& pending, std::chrono::steady_clock::time_point start, int error, bool rejected) {
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        uint64_t latency = std::chrono::duration_cast<std::chrono::microseconds>(end - pending.submission).count();
+        unsigned bucket = 0;
+
+        target.transactions++;
+
+        if(rejected)
+            target.rejected++;
+        else if(error >= 0) {
+            target.errors++;
+            target.errorsByErrno[error]++;
+        }
+
+        if(!rejected) {
+            for(const i2cOperation& operation : pending.transaction->getOperations())
+                target.bytes += (operation.type == OPERATION_READ ? operation.len : 1);
+
+            target.busyTime += end - start;
+        }
+
+        target.waitTime += start - pending.submission;
+
+        // Bucket i holds the latencies in [2^i, 2^(i+1)) us
+        while(latency > 1 && bucket < I2C_LATENCY_BUCKETS - 1) {
+            latency >>= 1;
+            bucket++;
+        }
+
+        target.latency[bucket]++;
+    }
+
+    void i2c_bus::send(i2c_transaction& transaction) {
+        route(transaction);
+
+        for(const i2cOperation& operation : transaction.getOperations()) {
+            if(operation.type == OPERATION_READ)
+                transport->readBlock(transaction.getAddress(), operation.reg, operation.buffer, operation.len);
+            else
+                transport->writeByte(transaction.getAddress(), operation.reg, operation.value);
+        }
+    }
+
+    void i2c_bus::perform(i2cPendingTransaction& pending) {
+        i2c_transaction& transaction = *pending.transaction;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        i2cDevice* device;
+
+        // Not accounted : no statistics nor circuit breaker, e.g. for the empty addresses of a scan
+        if(!transaction.isAccounted()) {
+            send(transaction);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> l(statsLock);
+            device = &devices[std::make_tuple(transaction.getMux(), transaction.getChannel(), transaction.getAddress())];
+            i2cDeviceHealth& health = device->health;
+
+            // Failing device : reject everything until the next probe
+            if(health.state == DEVICE_OPEN) {
+                if(start < health.nextProbe) {
+                    account(stats, pending, start, -1, true);
+                    account(device->stats, pending, start, -1, true);
+
+                    throw sensorException(fmt::format("Device 0x{0:x} is not responding, next probe in {1} ms", transaction.getAddress(),
+                        std::chrono::duration_cast<std::chrono::milliseconds>(health.nextProbe - start).count()), sensorErrorCode::I2C_ERROR);
+                }
+
+                // This transaction is the probe. A dead device fails on its first operation
+                health.state = DEVICE_HALF_OPEN;
+            }
+        }
+
+        try {
+            send(transaction);
+        } catch(sensorException& e) {
+            std::lock_guard<std::mutex> l(statsLock);
+            i2cDeviceHealth& health = device->health;
+
+            account(stats, pending, start, e.systemError(), false);
+            account(device->stats, pending, start, e.systemError(), false);
+
+            if(e.code() != sensorErrorCode::I2C_ERROR)
+                throw; // Not the device fault
+
+            health.failures++;
+
+            if(health.state == DEVICE_HALF_OPEN) {
+                // Failed probe, wait twice as long for the next one
+                health.backoff = std::min(health.backoff * 2, std::chrono::milliseconds(I2C_BACKOFF_MAX));
+                health.state = DEVICE_OPEN;
+            } else if(health.failures >= I2C_FAILURES_THRESHOLD) {
+                health.backoff = std::chrono::milliseconds(I2C_BACKOFF_MIN);
+                health.state = DEVICE_OPEN;
+            }
+
+            health.nextProbe = std::chrono::steady_clock::now() + health.backoff;
+            throw;
+        }
+
+        // The device is healthy
+        std::lock_guard<std::mutex> l(statsLock);
+
+        account(stats, pending, start, -1, false);
+        account(device->stats, pending, start, -1, false);
+
+        device->health.state = DEVICE_CLOSED;
+        device->health.failures = 0;
+    }
+
+}
@@ -0,0 +1,239 @@
+/**
+ * @file i2c_dev_transport.cc
+ * @brief I2C transport using the Linux i2c-dev interface implementation
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#include "i2c_dev_transport.h"
+
+namespace sensor {
+
+    i2c_dev_transport::i2c_dev_transport(const std::string& _path):path(_path) {
+        fd = -1;
+        selectedAddress = -1;
+        funcs = 0;
+        backend = BACKEND_READ_WRITE;
+    }
+
+    i2c_dev_transport::~i2c_dev_transport() {
+        if(fd >= 0)
+            close(fd);
+    }
+
+    int i2c_dev_transport::getFd() {
+        if(fd < 0) {
+            if((fd = open(path.c_str(), O_RDWR)) < 0) {
+                fd = -1;
+                throw sensorException(fmt::format("Failed to open the bus : {0}", strerror(errno)), sensorErrorCode::FILE_ERROR, errno);
+            }
+            selectedAddress = -1;
+
+            // Query the adapter once, and keep the fastest backend it supports. The SMBus backend
+            // also needs the single byte writes, to select the multiplexer channels
+            if(ioctl(fd, I2C_FUNCS, &funcs) < 0)
+                funcs = 0;
+
+            if(funcs & I2C_FUNC_I2C)
+                backend = BACKEND_RDWR;
+            else if((funcs & I2C_FUNC_SMBUS_READ_BYTE_DATA) && (funcs & I2C_FUNC_SMBUS_WRITE_BYTE_DATA) && (funcs & I2C_FUNC_SMBUS_WRITE_BYTE))
+                backend = BACKEND_SMBUS;
+            else
+                backend = BACKEND_READ_WRITE;
+        }
+
+        return fd;
+    }
+
+    void i2c_dev_transport::selectDevice(uint16_t address) {
+        int busFd = getFd();
+
+        if(selectedAddress == address)
+            return;
+
+        if(ioctl(busFd, I2C_SLAVE, address) < 0) {
+            selectedAddress = -1;
+            throw sensorException(fmt::format("Failed to select the device : {0}", strerror(errno)), sensorErrorCode::I2C_ERROR, errno);
+        }
+
+        selectedAddress = address;
+    }
+
+    i2cBackend i2c_dev_transport::getBackend() {
+        getFd();
+        return backend;
+    }
+
+    int i2c_dev_transport::smbusAccess(char readWrite, uint8_t command, int size, union i2c_smbus_data* data) {
+        struct i2c_smbus_ioctl_data args;
+
+        args.read_write = readWrite;
+        args.command = command;
+        args.size = size;
+        args.data = data;
+
+        return ioctl(fd, I2C_SMBUS, &args);
+    }
+
+    void i2c_dev_transport::readBlock(uint16_t address, uint8_t reg, uint8_t* buffer, size_t len) {
+        union i2c_smbus_data data;
+        size_t done = 0;
+
+        switch(getBackend()) {
+            case BACKEND_RDWR: {
+                struct i2c_msg messages[2];
+                struct i2c_rdwr_ioctl_data transaction;
+
+                // Write the register pointer, then read the response after a repeated start.
+                // The slave address is part of the messages, no need to select the device
+                messages[0].addr = address;
+                messages[0].flags = 0;
+                messages[0].len = 1;
+                messages[0].buf = &reg;
+
+                messages[1].addr = address;
+                messages[1].flags = I2C_M_RD;
+                messages[1].len = (uint16_t) len;
+                messages[1].buf = buffer;
+
+                transaction.msgs = messages;
+                transaction.nmsgs = 2;
+
+                if(ioctl(fd, I2C_RDWR, &transaction) != 2)
+                    goto error;
+                break;
+            }
+            case BACKEND_SMBUS:
+                selectDevice(address);
+
+                if(len == 2 && !(funcs & I2C_FUNC_SMBUS_READ_I2C_BLOCK) && (funcs & I2C_FUNC_SMBUS_READ_WORD_DATA)) {
+                    // SMBus words are little endian
+                    if(smbusAccess(I2C_SMBUS_READ, reg, I2C_SMBUS_WORD_DATA, &data) < 0)
+                        goto error;
+                    buffer[0] = data.word & 0xFF;
+                    buffer[1] = data.word >> 8;
+                    break;
+                }
+
+                while(done < len) {
+                    size_t chunk = len - done;
+
+                    if(chunk > 1 && (funcs & I2C_FUNC_SMBUS_READ_I2C_BLOCK)) {
+                        if(chunk > I2C_SMBUS_BLOCK_MAX)
+                            chunk = I2C_SMBUS_BLOCK_MAX;
+
+                        data.block[0] = (uint8_t) chunk;
+                        if(smbusAccess(I2C_SMBUS_READ, (uint8_t)(reg + done), I2C_SMBUS_I2C_BLOCK_DATA, &data) < 0)
+                            goto error;
+                        memcpy(buffer + done, data.block + 1, chunk);
+                    } else {
+                        chunk = 1;
+
+                        if(smbusAccess(I2C_SMBUS_READ, (uint8_t)(reg + done), I2C_SMBUS_BYTE_DATA, &data) < 0)
+                            goto error;
+                        buffer[done] = data.byte;
+                    }
+
+                    done += chunk;
+                }
+                break;
+            case BACKEND_READ_WRITE:
+                selectDevice(address);
+
+                // send the register address which want to read,
+                // and read the response
+                if(write(fd, &reg, 1) != 1 || read(fd, buffer, len) != (ssize_t) len)
+                    goto error;
+                break;
+        }
+
+        return;
+
+        error:
+        throw sensorException(fmt::format("Read register operation failed : {0}", strerror(errno)), sensorErrorCode::I2C_ERROR, errno);
+    }
+
+    void i2c_dev_transport::writeByte(uint16_t address, uint8_t reg, uint8_t value) {
+        uint8_t buffer[2] = { reg, value };
+        union i2c_smbus_data data;
+
+        switch(getBackend()) {
+            case BACKEND_RDWR: {
+                struct i2c_msg message;
+                struct i2c_rdwr_ioctl_data transaction;
+
+                message.addr = address;
+                message.flags = 0;
+                message.len = 2;
+                message.buf = buffer;
+
+                transaction.msgs = &message;
+                transaction.nmsgs = 1;
+
+                if(ioctl(fd, I2C_RDWR, &transaction) != 1)
+                    goto error;
+                break;
+            }
+            case BACKEND_SMBUS:
+                selectDevice(address);
+
+                data.byte = value;
+                if(smbusAccess(I2C_SMBUS_WRITE, reg, I2C_SMBUS_BYTE_DATA, &data) < 0)
+                    goto error;
+                break;
+            case BACKEND_READ_WRITE:
+                selectDevice(address);
+
+                // Send the register and the data
+                if(write(fd, buffer, 2) != 2)
+                    goto error;
+                break;
+        }
+
+        return;
+
+        error:
+        throw sensorException(fmt::format("Write register operation failed : {0}", strerror(errno)), sensorErrorCode::I2C_ERROR, errno);
+    }
+
+    void i2c_dev_transport::sendByte(uint16_t address, uint8_t value) {
+        union i2c_smbus_data data;
+
+        switch(getBackend()) {
+            case BACKEND_RDWR: {
+                struct i2c_msg message;
+                struct i2c_rdwr_ioctl_data transaction;
+
+                message.addr = address;
+                message.flags = 0;
+                message.len = 1;
+                message.buf = &value;
+
+                transaction.msgs = &message;
+                transaction.nmsgs = 1;
+
+                if(ioctl(fd, I2C_RDWR, &transaction) != 1)
+                    goto error;
+                break;
+            }
+            case BACKEND_SMBUS:
+                selectDevice(address);
+
+                if(smbusAccess(I2C_SMBUS_WRITE, value, I2C_SMBUS_BYTE, &data) < 0)
+                    goto error;
+                break;
+            case BACKEND_READ_WRITE:
+                selectDevice(address);
+
+                if(write(fd, &value, 1) != 1)
+                    goto error;
+                break;
+        }
+
+        return;
+
+        error:
+        throw sensorException(fmt::format("Send byte operation failed : {0}", strerror(errno)), sensorErrorCode::I2C_ERROR, errno);
+    }
+
+}
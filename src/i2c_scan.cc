@@ -0,0 +1,199 @@
+/**
+ * @file i2c_scan.cc
+ * @brief Discovery of the known I2C sensors of a bus implementation
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#include "i2c_scan.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#include <vector>
+#include <future>
+#include <type_traits>
+
+#include "i2c_bus.h"
+#include "i2c_transaction.h"
+
+namespace sensor {
+
+    std::list<i2cScanDevice> i2c_scanner::scan(const std::string& path, unsigned maxAge) {
+        const std::string bus = path.empty() ? I2C_BUS_FILE : path;
+        std::list<i2cScanDevice> devices;
+
+        if(maxAge > 0 && loadCache(bus, maxAge, devices))
+            return devices;
+
+        devices = probe(bus);
+        saveCache(bus, devices);
+
+        return devices;
+    }
+
+    i2cScanResult i2c_scanner::scanOrError(const std::string& path, unsigned maxAge) {
+        i2cScanResult result;
+
+        try {
+            result.devices = scan(path, maxAge);
+        } catch(sensorException& e) {
+            result.failed = true;
+            result.error = e;
+        }
+
+        return result;
+    }
+
+    // Addresses where a known sensor may be, and their ID register : 0xD0 for a BMP180, always at
+    // 0x77, and 0xA with the command bit for a TSL2561, at 0x29, 0x39 or 0x49. No other address is
+    // probed, as writing a register pointer may corrupt other devices (e.g. the address pointer of
+    // the 24Cxx EEPROMs, from 0x50 to 0x57)
+    static const uint16_t probedAddresses[4] = { 0x29, 0x39, 0x49, 0x77 };
+    static const uint8_t probedRegisters[4] = { 0x8A, 0x8A, 0x8A, 0xD0 };
+
+    std::list<i2cScanDevice> i2c_scanner::probe(const std::string& path) {
+        const size_t count = std::extent<decltype(probedAddresses)>::value;
+        std::list<i2cScanDevice> devices;
+        std::vector<i2c_transaction> transactions;
+        std::vector<std::future<void>> probes;
+        std::vector<uint8_t> ids(count);
+
+        transactions.reserve(count);
+        probes.reserve(count);
+
+        i2c_bus* bus = i2c_bus::acquire(path);
+
+        // Submit every probe before waiting for any, so they are performed back to back
+        for(size_t i = 0; i < count; i++) {
+            transactions.emplace_back(probedAddresses[i]);
+            transactions.back().read(probedRegisters[i], &ids[i], 1);
+            transactions.back().setAccounted(false); // Most addresses are empty, and should not trip any breaker
+            probes.push_back(bus->submit(transactions.back()));
+        }
+
+        // Every probe must be completed before the transactions are freed
+        std::vector<bool> found(count, false);
+        sensorException error;
+        bool failed = false;
+
+        for(size_t i = 0; i < count; i++) {
+            try {
+                probes[i].get();
+                found[i] = true;
+            } catch(sensorException& e) {
+                if(e.code() != sensorErrorCode::I2C_ERROR && !failed) {
+                    error = e; // Not a missing device, but a bus failure
+                    failed = true;
+                }
+            }
+        }
+
+        i2c_bus::release(bus);
+
+        if(failed)
+            throw error;
+
+        for(size_t i = 0; i < count; i++) {
+            i2cScanDevice device;
+            device.address = probedAddresses[i];
+            identify(ids[i], device);
+
+            if(found[i] && !device.type.empty())
+                devices.push_back(device);
+        }
+
+        return devices;
+    }
+
+    void i2c_scanner::identify(uint8_t id, i2cScanDevice& device) {
+        if(device.address == 0x77) {
+            if(id == 0x55)
+                device.type = "BMP180";
+            return;
+        }
+
+        // The part number of a TSL2561 tells its package : 0x5 for the T, FN and CL packages, which
+        // share the same lux computation, or 0x1 for the CS package
+        if((id & 0xF0) == 0x50) {
+            device.type = "TSL2561";
+            device.package = "T";
+        } else if((id & 0xF0) == 0x10) {
+            device.type = "TSL2561";
+            device.package = "CS";
+        }
+    }
+
+    std::string i2c_scanner::cacheFile(const std::string& path) {
+        if(path.empty() || path[0] != '/')
+            return ""; // Simulated, recorded or replayed buses are not cached
+
+        std::string name = path;
+
+        for(char& c : name) {
+            if(c == '/' || c == ':')
+                c = '_';
+        }
+
+        return fmt::format("{0}/raspi-sensors-scan{1}", I2C_SCAN_CACHE_DIR, name);
+    }
+
+    bool i2c_scanner::loadCache(const std::string& path, unsigned maxAge, std::list<i2cScanDevice>& devices) {
+        const std::string file = cacheFile(path);
+
+        if(file.empty())
+            return false;
+
+        FILE* f = fopen(file.c_str(), "r");
+
+        if(!f)
+            return false;
+
+        long long timestamp;
+        char type[32], package[8];
+        unsigned address;
+        bool valid = (fscanf(f, "I2CSCAN02 %lld", &timestamp) == 1) && time(NULL) - timestamp < (long long) maxAge;
+
+        while(valid && fscanf(f, "%x %31s %7s", &address, type, package) == 3) {
+            i2cScanDevice device;
+            device.address = address;
+            device.type = type;
+            device.package = (package[0] == '-' ? "" : package);
+            devices.push_back(device);
+        }
+
+        valid = valid && feof(f);
+        fclose(f);
+
+        if(!valid)
+            devices.clear();
+
+        return valid;
+    }
+
+    void i2c_scanner::saveCache(const std::string& path, const std::list<i2cScanDevice>& devices) {
+        const std::string file = cacheFile(path);
+
+        if(file.empty())
+            return;
+
+        // Written aside then renamed, so a concurrent load never sees a partial cache
+        const std::string temporary = file + ".tmp";
+        FILE* f = fopen(temporary.c_str(), "w");
+
+        if(!f)
+            return;
+
+        bool written = fprintf(f, "I2CSCAN02 %lld\n", (long long) time(NULL)) > 0;
+
+        for(const i2cScanDevice& device : devices)
+            written = written && fprintf(f, "%x %s %s\n", device.address, device.type.c_str(),
+                                         device.package.empty() ? "-" : device.package.c_str()) > 0;
+
+        if(fclose(f) == 0 && written)
+            rename(temporary.c_str(), file.c_str());
+        else
+            remove(temporary.c_str());
+    }
+
+}
@@ -7,11 +7,6 @@
 
 #include "i2c_sensor.h"
 
-#ifndef I2C_BUS_FILE
-    // Where to read on the i2c bus, should be setted from from node-gyp
-    #define I2C_BUS_FILE "/dev/i2c-1"
-#endif
-
 /**
  * @namespace sensor
  *
@@ -19,41 +14,26 @@
  */
 namespace sensor {
 
-    i2c_sensor::i2c_sensor(uint16_t _deviceAddress, std::string _name):sensor(_name) {
+    i2c_sensor::i2c_sensor(uint16_t _deviceAddress, std::string _name, const sensorOptions& options):sensor(_name) {
         deviceAddress = _deviceAddress;
-        i2c_fd = -1;
-    }
+        mux = options.mux;
+        channel = options.channel;
+        bus = i2c_bus::acquire(options.bus.empty() ? I2C_BUS_FILE : options.bus);
 
-    i2c_sensor::~i2c_sensor() {}
-
-    /**
-     * Open the bus to read data from. If the opening failed, the filed
-     * descriptor is set to -1
-     * @return          The bus descriptor, or -1 on error
-     */
-    void i2c_sensor::openBus() {
-        if ((i2c_fd = open(I2C_BUS_FILE, O_RDWR)) < 0) {
-            i2c_fd = -1;
-            throw sensorException(fmt::format("Failed to open the bus : {0}", strerror(errno)), sensorErrorCode::FILE_ERROR);
-        }
+        if(mux >= 0)
+            bus->addMux(mux);
     }
 
-    /**
-     * Close the bus
-     */
-    void i2c_sensor::closeBus() {
-        if(i2c_fd > 0) {
-            close(i2c_fd);
-            i2c_fd = -1;
-        }
+    i2c_sensor::~i2c_sensor() {
+        i2c_bus::release(bus);
     }
 
     /**
-     * Return the file descriptor of the bus, or -1
-     * @return The bus file descriptor
+     * Return the bus used by the sensor
+     * @return The bus handle
      */
-    int i2c_sensor::getBus() {
-        return i2c_fd;
+    i2c_bus* i2c_sensor::getBus() {
+        return bus;
     }
 
     /**
@@ -70,31 +50,10 @@ namespace sensor {
      * @return          The value read
      */
     uint16_t i2c_sensor::readRegister(uint16_t address) {
-        uint16_t response = 0x0;
+        uint8_t response = 0x0;
 
-        // Open the bus
-        openBus();
+        readRegisterBlock(address, &response, 1);
 
-        // Try to acquire the bus access
-        if(ioctl(getBus(), I2C_SLAVE, getDeviceAddress()) < 0)
-            goto error;
-
-        // send the register address which want to read,
-        // and read the response
-        if(write(getBus(), &address, 1) != 1)
-            goto error;
-        if(read(getBus(), &response, 1) != 1)
-            goto error;
-
-        goto end;
-
-        error:
-        closeBus();
-        throw sensorException(fmt::format("Read register operation failed : {0}", strerror(errno)), sensorErrorCode::I2C_ERROR);
-        return 0x0;
-
-        end:
-        closeBus();
         return response;
     }
     
@@ -104,35 +63,25 @@ namespace sensor {
      * @return          The integer read
      */
     uint16_t i2c_sensor::readRegisterInt(uint16_t address) {
-        uint16_t response = 0x0;
         uint8_t buffer[2] = {0,0};
 
-        // Open the bus
-        openBus();
-
-        // Try to acquire the bus access
-        if(ioctl(getBus(), I2C_SLAVE, getDeviceAddress()) < 0)
-            goto error;
-
-        // send the register address which want to read,
-        // and read the response
-        if(write(getBus(), &address, 1) != 1)
-            goto error;
-        if(read(getBus(), buffer, 2) != 2)
-            goto error;
-
-        response = (int16_t) buffer[0]<<8 | buffer[1];
+        readRegisterBlock(address, buffer, 2);
 
-        goto end;
+        return (int16_t) buffer[0]<<8 | buffer[1];
+    }
 
-        error:
-        closeBus();
-        throw sensorException(fmt::format("Read register operation failed : {0}", strerror(errno)), sensorErrorCode::I2C_ERROR);
-        return 0x0;
+    /**
+     * Read consecutive registers, starting at the specified one. The register pointer write
+     * and the read are performed in a single combined transaction (repeated start)
+     * @param  uint16_t The register where to start reading
+     * @param  uint8_t* The buffer to read into
+     * @param  size_t   The number of bytes to read
+     */
+    void i2c_sensor::readRegisterBlock(uint16_t address, uint8_t* buffer, size_t len) {
+        i2c_transaction transaction(getDeviceAddress());
+        transaction.read((uint8_t) address, buffer, len);
 
-        end:
-        closeBus();
-        return response;
+        execute(transaction);
     }
     
     /**
@@ -141,31 +90,20 @@ namespace sensor {
      * @param  uint16_t The value to write
      */
     void i2c_sensor::writeRegister(uint16_t address, uint16_t value) {
-        int8_t buf[2] = {0}; // buffer for write.
-
-        // Open the bus
-        openBus();
-
-        // Try to acquire the bus access
-        if(ioctl(getBus(), I2C_SLAVE, getDeviceAddress()) < 0)
-            goto error;
-
-        buf[0] = (int8_t)address;
-        buf[1] = (int8_t)value;
+        i2c_transaction transaction(getDeviceAddress());
+        transaction.write((uint8_t) address, (uint8_t) value);
 
-        // Send the register and the data
-        if(write(getBus(), buf, 2) != 2)
-            goto error;
-
-        goto end;
-
-        error:
-        closeBus();
-        throw sensorException(fmt::format("Write register operation failed : {0}", strerror(errno)), sensorErrorCode::I2C_ERROR);
+        execute(transaction);
+    }
 
-        end:
-        closeBus();
+    /**
+     * Perform a transaction on the bus, and wait for its completion. The operations of
+     * the transaction are performed back to back
+     * @param i2c_transaction The transaction to perform
+     */
+    void i2c_sensor::execute(i2c_transaction& transaction) {
+        transaction.setRoute(mux, channel);
+        bus->execute(transaction);
     }
 
 }
-
@@ -0,0 +1,75 @@
+/**
+ * @file i2c_sim_transport.cc
+ * @brief Simulated I2C transport implementation
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#include "i2c_sim_transport.h"
+
+namespace sensor {
+
+    i2c_sim_transport::i2c_sim_transport(unsigned _clock) {
+        clock = _clock;
+    }
+
+    i2c_sim_transport::~i2c_sim_transport() {
+        for(auto& device : devices)
+            delete device.second;
+    }
+
+    void i2c_sim_transport::attach(uint16_t address, i2c_sim_device* device) {
+        auto it = devices.find(address);
+
+        if(it != devices.end())
+            delete it->second;
+
+        devices[address] = device;
+    }
+
+    void i2c_sim_transport::transfer(size_t bits) {
+        if(clock > 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(bits * 1000 / clock));
+    }
+
+    void i2c_sim_transport::readBlock(uint16_t address, uint8_t reg, uint8_t* buffer, size_t len) {
+        auto it = devices.find(address);
+
+        // Start, address + register, repeated start, address, data, stop. Without any device,
+        // only the address is sent and not acknowledged
+        if(it == devices.end()) {
+            transfer(11);
+            throw sensorException(fmt::format("Read register operation failed : {0}", strerror(ENXIO)), sensorErrorCode::I2C_ERROR, ENXIO);
+        }
+
+        transfer(3 + 9 * (3 + len));
+        it->second->read(reg, buffer, len);
+    }
+
+    void i2c_sim_transport::writeByte(uint16_t address, uint8_t reg, uint8_t value) {
+        auto it = devices.find(address);
+
+        // Start, address + register + value, stop
+        if(it == devices.end()) {
+            transfer(11);
+            throw sensorException(fmt::format("Write register operation failed : {0}", strerror(ENXIO)), sensorErrorCode::I2C_ERROR, ENXIO);
+        }
+
+        transfer(2 + 9 * 3);
+        it->second->write(reg, value);
+    }
+
+    void i2c_sim_transport::sendByte(uint16_t address, uint8_t value) {
+        auto it = devices.find(address);
+
+        // Start, address + value, stop
+        if(it == devices.end()) {
+            transfer(11);
+            throw sensorException(fmt::format("Send byte operation failed : {0}", strerror(ENXIO)), sensorErrorCode::I2C_ERROR, ENXIO);
+        }
+
+        transfer(2 + 9 * 2);
+        it->second->send(value);
+    }
+
+}
@@ -0,0 +1,236 @@
+/**
+ * @file i2c_trace_transport.cc
+ * @brief I2C record and replay transports implementation
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#include "i2c_trace_transport.h"
+
+namespace sensor {
+
+    // Description of an operation, for the errors
+    static std::string describe(uint16_t address, uint8_t reg, uint8_t flags, const uint8_t* data, size_t len) {
+        if(flags & I2C_TRACE_SEND)
+            return fmt::format("send of 0x{0:x} to 0x{1:x}", reg, address);
+        else if(flags & I2C_TRACE_READ)
+            return fmt::format("read of {0} bytes at 0x{1:x} register 0x{2:x}", len, address, reg);
+        else
+            return fmt::format("write of 0x{0:x} at 0x{1:x} register 0x{2:x}", len > 0 ? data[0] : 0, address, reg);
+    }
+
+    // i2c_record_transport class
+    i2c_record_transport::i2c_record_transport(i2c_transport* _transport, const std::string& _path, uint8_t _bus):path(_path) {
+        transport = _transport;
+        bus = _bus;
+        fd = -1;
+    }
+
+    i2c_record_transport::~i2c_record_transport() {
+        if(fd >= 0)
+            close(fd);
+
+        delete transport;
+    }
+
+    void i2c_record_transport::record(uint16_t address, uint8_t reg, uint8_t flags, const uint8_t* data, size_t len) {
+        uint8_t buffer[I2C_TRACE_HEADER_SIZE + 255];
+        uint64_t timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+
+        if(fd < 0) {
+            // Open the trace, and start it if empty
+            if((fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644)) < 0) {
+                fd = -1;
+                throw sensorException(fmt::format("Failed to open the trace : {0}", strerror(errno)), sensorErrorCode::FILE_ERROR);
+            }
+
+            if(lseek(fd, 0, SEEK_END) == 0 && write(fd, I2C_TRACE_MAGIC, 8) != 8)
+                throw sensorException(fmt::format("Failed to write the trace : {0}", strerror(errno)), sensorErrorCode::FILE_ERROR);
+        }
+
+        for(int i = 0; i < 8; i++)
+            buffer[i] = (timestamp >> (i * 8)) & 0xFF;
+
+        buffer[8] = bus;
+        buffer[9] = address & 0xFF;
+        buffer[10] = address >> 8;
+        buffer[11] = reg;
+        buffer[12] = flags;
+        buffer[13] = (uint8_t) len;
+
+        if(buffer[13] > 0)
+            memcpy(buffer + I2C_TRACE_HEADER_SIZE, data, len);
+
+        // A single write, so a record is never split
+        size_t size = I2C_TRACE_HEADER_SIZE + buffer[13];
+
+        if(write(fd, buffer, size) != (ssize_t) size)
+            throw sensorException(fmt::format("Failed to write the trace : {0}", strerror(errno)), sensorErrorCode::FILE_ERROR);
+    }
+
+    void i2c_record_transport::readBlock(uint16_t address, uint8_t reg, uint8_t* buffer, size_t len) {
+        // Never truncated, it would be replayed wrong. Checked before the read, to fail without
+        // touching the device, and not as an I2C error : the device isn't at fault
+        if(len > 255)
+            throw sensorException(fmt::format("Cannot record a read of {0} bytes (255 max)", len), sensorErrorCode::FILE_ERROR);
+
+        try {
+            transport->readBlock(address, reg, buffer, len);
+        } catch(sensorException& e) {
+            uint8_t error = (uint8_t) e.systemError();
+            record(address, reg, I2C_TRACE_READ | I2C_TRACE_ERROR, &error, 1);
+            throw;
+        }
+
+        record(address, reg, I2C_TRACE_READ, buffer, len);
+    }
+
+    void i2c_record_transport::writeByte(uint16_t address, uint8_t reg, uint8_t value) {
+        try {
+            transport->writeByte(address, reg, value);
+        } catch(sensorException& e) {
+            uint8_t error = (uint8_t) e.systemError();
+            record(address, reg, I2C_TRACE_ERROR, &error, 1);
+            throw;
+        }
+
+        record(address, reg, 0x0, &value, 1);
+    }
+
+    void i2c_record_transport::sendByte(uint16_t address, uint8_t value) {
+        try {
+            transport->sendByte(address, value);
+        } catch(sensorException& e) {
+            uint8_t error = (uint8_t) e.systemError();
+            record(address, value, I2C_TRACE_SEND | I2C_TRACE_ERROR, &error, 1);
+            throw;
+        }
+
+        record(address, value, I2C_TRACE_SEND, NULL, 0);
+    }
+
+    // i2c_replay_transport class
+    i2c_replay_transport::i2c_replay_transport(const std::string& _path, bool _realTime):path(_path) {
+        realTime = _realTime;
+        file = NULL;
+        started = false;
+        firstTimestamp = 0;
+
+        // Opened right away, so an invalid trace is reported with the configuration
+        try {
+            index();
+        } catch(sensorException& e) {
+            if(file)
+                fclose(file);
+
+            throw;
+        }
+    }
+
+    i2c_replay_transport::~i2c_replay_transport() {
+        if(file)
+            fclose(file);
+    }
+
+    bool i2c_replay_transport::readRecord(i2cTraceRecord& record) {
+        uint8_t header[I2C_TRACE_HEADER_SIZE];
+        size_t size = fread(header, 1, I2C_TRACE_HEADER_SIZE, file);
+
+        if(size == 0 && feof(file))
+            return false;
+
+        if(size != I2C_TRACE_HEADER_SIZE)
+            throw sensorException(fmt::format("Truncated trace file : {0}", path), sensorErrorCode::FILE_ERROR);
+
+        record.timestamp = 0;
+        for(int i = 0; i < 8; i++)
+            record.timestamp |= (uint64_t) header[i] << (i * 8);
+
+        record.bus = header[8];
+        record.address = header[9] | (header[10] << 8);
+        record.reg = header[11];
+        record.flags = header[12];
+        record.len = header[13];
+
+        if(fread(record.data, 1, record.len, file) != record.len)
+            throw sensorException(fmt::format("Truncated trace file : {0}", path), sensorErrorCode::FILE_ERROR);
+
+        return true;
+    }
+
+    void i2c_replay_transport::index() {
+        char magic[8];
+
+        if(!(file = fopen(path.c_str(), "rb")))
+            throw sensorException(fmt::format("Failed to open the trace : {0}", strerror(errno)), sensorErrorCode::FILE_ERROR);
+
+        if(fread(magic, 1, 8, file) != 8 || memcmp(magic, I2C_TRACE_MAGIC, 8) != 0)
+            throw sensorException(fmt::format("Invalid trace file : {0}", path), sensorErrorCode::FILE_ERROR);
+
+        // Only the offsets are kept, the records being read again when replayed
+        for(off_t offset = ftello(file); readRecord(current); offset = ftello(file)) {
+            if(records.empty())
+                firstTimestamp = current.timestamp;
+
+            records[current.address].push_back(offset);
+        }
+    }
+
+    const i2cTraceRecord& i2c_replay_transport::next(uint16_t address, uint8_t reg, uint8_t flags, const uint8_t* data, size_t len) {
+        auto it = records.find(address);
+
+        if(it == records.end() || it->second.empty())
+            throw sensorException(fmt::format("End of the trace reached for 0x{0:x}", address), sensorErrorCode::FILE_ERROR);
+
+        if(fseeko(file, it->second.front(), SEEK_SET) != 0 || !readRecord(current))
+            throw sensorException(fmt::format("Failed to read the trace : {0}", strerror(errno)), sensorErrorCode::FILE_ERROR);
+
+        it->second.pop_front();
+
+        // The replayed operations should follow the trace of their device exactly. The bytes
+        // of a failed operation are its errno, and can't be compared
+        uint8_t kind = current.flags & (I2C_TRACE_READ | I2C_TRACE_SEND);
+        bool differs = current.reg != reg || kind != flags;
+
+        if(!differs && !(current.flags & I2C_TRACE_ERROR))
+            differs = current.len != len || (data && memcmp(current.data, data, len) != 0);
+
+        if(differs)
+            throw sensorException(fmt::format("Trace mismatch : {0} replayed, {1} recorded", describe(address, reg, flags, data, len),
+                                              describe(current.address, current.reg, kind, current.data, current.len)), sensorErrorCode::FILE_ERROR);
+
+        if(realTime) {
+            // Wait for the time of the record, relative to the first one of the trace
+            if(!started)
+                firstTime = std::chrono::steady_clock::now();
+
+            if(current.timestamp > firstTimestamp)
+                std::this_thread::sleep_until(firstTime + std::chrono::microseconds(current.timestamp - firstTimestamp));
+        }
+
+        started = true;
+
+        if(current.flags & I2C_TRACE_ERROR) {
+            int error = current.len > 0 ? current.data[0] : EIO;
+            throw sensorException(fmt::format("Recorded operation failed : {0}", strerror(error)), sensorErrorCode::I2C_ERROR, error);
+        }
+
+        return current;
+    }
+
+    void i2c_replay_transport::readBlock(uint16_t address, uint8_t reg, uint8_t* buffer, size_t len) {
+        const i2cTraceRecord& r = next(address, reg, I2C_TRACE_READ, NULL, len);
+
+        memcpy(buffer, r.data, len);
+    }
+
+    void i2c_replay_transport::writeByte(uint16_t address, uint8_t reg, uint8_t value) {
+        next(address, reg, 0x0, &value, 1);
+    }
+
+    void i2c_replay_transport::sendByte(uint16_t address, uint8_t value) {
+        next(address, value, I2C_TRACE_SEND, NULL, 0);
+    }
+
+}
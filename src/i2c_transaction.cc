@@ -0,0 +1,76 @@
+/**
+ * @file i2c_transaction.cc
+ * @brief Batch of I2C operations implementation
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#include "i2c_transaction.h"
+
+namespace sensor {
+
+    i2c_transaction::i2c_transaction(uint16_t _address) {
+        address = _address;
+        mux = -1;
+        channel = -1;
+        accounted = true;
+    }
+
+    i2c_transaction::~i2c_transaction() {}
+
+    i2c_transaction& i2c_transaction::read(uint8_t reg, uint8_t* buffer, size_t len) {
+        i2cOperation operation;
+
+        operation.type = OPERATION_READ;
+        operation.reg = reg;
+        operation.buffer = buffer;
+        operation.len = len;
+        operation.value = 0x0;
+
+        operations.push_back(operation);
+        return *this;
+    }
+
+    i2c_transaction& i2c_transaction::write(uint8_t reg, uint8_t value) {
+        i2cOperation operation;
+
+        operation.type = OPERATION_WRITE;
+        operation.reg = reg;
+        operation.buffer = nullptr;
+        operation.len = 0;
+        operation.value = value;
+
+        operations.push_back(operation);
+        return *this;
+    }
+
+    void i2c_transaction::setRoute(int _mux, int _channel) {
+        mux = _mux;
+        channel = _channel;
+    }
+
+    void i2c_transaction::setAccounted(bool _accounted) {
+        accounted = _accounted;
+    }
+
+    bool i2c_transaction::isAccounted() {
+        return accounted;
+    }
+
+    uint16_t i2c_transaction::getAddress() {
+        return address;
+    }
+
+    int i2c_transaction::getMux() {
+        return mux;
+    }
+
+    int i2c_transaction::getChannel() {
+        return channel;
+    }
+
+    const std::vector<i2cOperation>& i2c_transaction::getOperations() {
+        return operations;
+    }
+
+}
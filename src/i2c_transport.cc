@@ -0,0 +1,58 @@
+/**
+ * @file i2c_transport.cc
+ * @brief Creation of the I2C transports
+ * @author Vuzi
+ * @version 0.2
+ */
+
+#include "i2c_transport.h"
+#include "i2c_dev_transport.h"
+#include "i2c_sim_transport.h"
+#include "i2c_trace_transport.h"
+#include "BMP180_sim.h"
+#include "TSL2561_sim.h"
+
+namespace sensor {
+
+    i2c_transport* i2c_transport::create(const std::string& path) {
+        if(path.compare(0, 7, "record:") == 0) {
+            // Recorded bus, as record:<trace file>[:<bus>]
+            size_t separator = path.find(':', 7);
+            std::string bus = (separator == std::string::npos ? I2C_BUS_FILE : path.substr(separator + 1));
+            unsigned busNumber = 0xFF;
+
+            if(bus.compare(0, 9, "/dev/i2c-") == 0)
+                busNumber = (unsigned) strtoul(bus.c_str() + 9, NULL, 10);
+
+            return new i2c_record_transport(create(bus), path.substr(7, separator - 7), (uint8_t) busNumber);
+        }
+
+        if(path.compare(0, 7, "replay:") == 0)
+            return new i2c_replay_transport(path.substr(7), false);
+
+        if(path.compare(0, 16, "replay-realtime:") == 0)
+            return new i2c_replay_transport(path.substr(16), true);
+
+        if(path == "sim" || path.compare(0, 4, "sim:") == 0) {
+            // Simulated bus, with a BMP180 and a TSL2561 at their default addresses
+            unsigned clock = 100;
+
+            if(path.size() > 3) {
+                if(path.size() == 4 || path.find_first_not_of("0123456789", 4) != std::string::npos)
+                    throw sensorException(fmt::format("Invalid simulated bus '{0}', expected sim or sim:<clock in kHz>", path),
+                                          sensorErrorCode::I2C_ERROR);
+
+                clock = (unsigned) strtoul(path.c_str() + 4, NULL, 10);
+            }
+
+            i2c_sim_transport* transport = new i2c_sim_transport(clock);
+            transport->attach(0x77, new BMP180_sim_device());
+            transport->attach(0x39, new TSL2561_sim_device());
+
+            return transport;
+        }
+
+        return new i2c_dev_transport(path);
+    }
+
+}
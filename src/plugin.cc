@@ -9,6 +9,7 @@
 #include <node.h>
 
 #include "wrapper_sensor.h"
+#include "wrapper_bus.h"
 
 using namespace v8;
 
@@ -19,6 +20,9 @@ void InitAll(Local<Object> exports) {
 
 	// Export sensor wrapper
 	SensorWrapper::Init(exports);
+
+	// Export bus functions
+	BusWrapper::Init(exports);
 }
 
 NODE_MODULE(meteonetwork, InitAll)
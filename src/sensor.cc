@@ -37,8 +37,10 @@ namespace sensor {
     }
     
     // sensorException class
-    sensorException::sensorException(const std::string& msg, sensorErrorCode _errorCode) : runtime_error(msg) {
+    sensorException::sensorException(const std::string& msg, sensorErrorCode _errorCode, int _errorNumber) : runtime_error(msg) {
         errorCode = _errorCode;
+        errorNumber = _errorNumber;
+        retryable = false;
     }
 
     sensorException::sensorException() : sensorException("", sensorErrorCode::NONE) {}
@@ -50,4 +52,21 @@ namespace sensor {
     sensorErrorCode sensorException::code() {
         return errorCode;
     }
+
+    int sensorException::systemError() {
+        return errorNumber;
+    }
+
+    void sensorException::setRetry(std::chrono::steady_clock::time_point time) {
+        retryable = true;
+        retryAt = time;
+    }
+
+    bool sensorException::isRetryable() {
+        return retryable;
+    }
+
+    std::chrono::steady_clock::time_point sensorException::retryTime() {
+        return retryAt;
+    }
 }
@@ -8,6 +8,7 @@ namespace sensor {
     result::result(resultType _t, resultValue _r) {
         t = _t;
         r  = _r;
+        stale = false;
         date = std::chrono::system_clock::now(); // Get current time
     }
     
@@ -29,6 +30,14 @@ namespace sensor {
         return std::chrono::duration_cast<std::chrono::milliseconds>(date.time_since_epoch()).count();
     }
 
+    void result::setStale() {
+        stale = true;
+    }
+
+    bool result::isStale() {
+        return stale;
+    }
+
     // resultsOrError class
     resultsOrError::resultsOrError() {}
     
@@ -54,4 +63,15 @@ namespace sensor {
         return !hasError();
     }
 
+    int resultsOrError::getRetryDelay() {
+        if(!hasError() || !error.isRetryable())
+            return -1;
+
+        // Rounded up to the next millisecond, not to retry too soon
+        long long delay = std::chrono::duration_cast<std::chrono::microseconds>(
+            error.retryTime() - std::chrono::steady_clock::now()).count();
+
+        return delay > 0 ? (int) ((delay + 999) / 1000) : 0;
+    }
+
 }
@@ -0,0 +1,154 @@
+#include "wrapper_bus.h"
+
+using namespace v8;
+
+Local<Object> BusWrapper::ConvertStats(const sensor::i2cStats& stats, Isolate* isolate) {
+    Local<Object> result = Object::New(isolate);
+    Local<Object> errorsByErrno = Object::New(isolate);
+    Local<Array> latency = Array::New(isolate, I2C_LATENCY_BUCKETS);
+
+    for(auto& error : stats.errorsByErrno)
+        errorsByErrno->Set(Number::New(isolate, error.first), Number::New(isolate, (double) error.second));
+
+    for(unsigned i = 0; i < I2C_LATENCY_BUCKETS; i++)
+        latency->Set(i, Number::New(isolate, (double) stats.latency[i]));
+
+    result->Set(String::NewFromUtf8(isolate, "transactions"), Number::New(isolate, (double) stats.transactions));
+    result->Set(String::NewFromUtf8(isolate, "bytes"), Number::New(isolate, (double) stats.bytes));
+    result->Set(String::NewFromUtf8(isolate, "errors"), Number::New(isolate, (double) stats.errors));
+    result->Set(String::NewFromUtf8(isolate, "rejected"), Number::New(isolate, (double) stats.rejected));
+    result->Set(String::NewFromUtf8(isolate, "errorsByErrno"), errorsByErrno);
+    result->Set(String::NewFromUtf8(isolate, "busyTime"), Number::New(isolate, stats.busyTime.count() / 1e6));
+    result->Set(String::NewFromUtf8(isolate, "waitTime"), Number::New(isolate, stats.waitTime.count() / 1e6));
+    result->Set(String::NewFromUtf8(isolate, "latency"), latency);
+
+    return result;
+}
+
+void BusWrapper::Stats(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+    Local<Object> result = Object::New(isolate);
+
+    for(sensor::i2cBusStats& busStats : sensor::i2c_bus::getAllStats()) {
+        Local<Object> bus = ConvertStats(busStats.stats, isolate);
+        Local<Array> devices = Array::New(isolate, busStats.devices.size());
+        unsigned i = 0;
+
+        for(sensor::i2cDeviceStats& deviceStats : busStats.devices) {
+            Local<Object> device = ConvertStats(deviceStats.stats, isolate);
+
+            device->Set(String::NewFromUtf8(isolate, "address"), Number::New(isolate, deviceStats.address));
+
+            if(deviceStats.mux >= 0) {
+                device->Set(String::NewFromUtf8(isolate, "mux"), Number::New(isolate, deviceStats.mux));
+                device->Set(String::NewFromUtf8(isolate, "channel"), Number::New(isolate, deviceStats.channel));
+            }
+
+            device->Set(String::NewFromUtf8(isolate, "failing"), Boolean::New(isolate, deviceStats.state != sensor::DEVICE_CLOSED));
+            devices->Set(i++, device);
+        }
+
+        bus->Set(String::NewFromUtf8(isolate, "utilization"), Number::New(isolate, busStats.utilization));
+        bus->Set(String::NewFromUtf8(isolate, "devices"), devices);
+        result->Set(String::NewFromUtf8(isolate, busStats.path.c_str()), bus);
+    }
+
+    args.GetReturnValue().Set(result);
+}
+
+void BusWrapper::SendScan(const std::string& bus, sensor::i2cScanResult& r, Isolate* isolate, Local<Function>& cb) {
+    if(r.failed) {
+        Local<Object> error = Object::New(isolate);
+
+        error->Set(String::NewFromUtf8(isolate, "cause"), String::NewFromUtf8(isolate, r.error.what()));
+        error->Set(String::NewFromUtf8(isolate, "code"), Number::New(isolate, r.error.code()));
+
+        if(r.error.systemError())
+            error->Set(String::NewFromUtf8(isolate, "errno"), Number::New(isolate, r.error.systemError()));
+
+        Local<Value> argv[2] = { error, Undefined(isolate) };
+        cb->Call(isolate->GetCurrentContext()->Global(), 2, argv);
+        return;
+    }
+
+    // Configurations ready to be used to create the sensors
+    Local<Array> configs = Array::New(isolate, r.devices.size());
+    unsigned i = 0;
+
+    for(sensor::i2cScanDevice& device : r.devices) {
+        Local<Object> config = Object::New(isolate);
+
+        config->Set(String::NewFromUtf8(isolate, "type"), String::NewFromUtf8(isolate, device.type.c_str()));
+        config->Set(String::NewFromUtf8(isolate, "address"), Number::New(isolate, device.address));
+
+        if(!device.package.empty())
+            config->Set(String::NewFromUtf8(isolate, "package"), String::NewFromUtf8(isolate, device.package.c_str()));
+
+        if(!bus.empty())
+            config->Set(String::NewFromUtf8(isolate, "bus"), String::NewFromUtf8(isolate, bus.c_str()));
+
+        configs->Set(i++, config);
+    }
+
+    Local<Value> argv[2] = { Null(isolate), configs };
+    cb->Call(isolate->GetCurrentContext()->Global(), 2, argv);
+}
+
+void BusWrapper::Scan(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+    std::string bus;
+
+    // I2C bus, either a bus number or the path of its file
+    if(args[0]->IsNumber() && args[0]->NumberValue() >= 0) {
+        bus = fmt::format("/dev/i2c-{0}", (int) args[0]->NumberValue());
+    } else if(args[0]->IsString()) {
+        String::Utf8Value value(args[0]->ToString());
+        bus = std::string(*value);
+    } else if(!args[0]->IsUndefined() && !args[0]->IsNull()) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate, "Error : the bus should be a bus number (number >= 0) or a bus file")));
+        return;
+    }
+
+    if(!args[1]->IsFunction()) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate, "Error : no callback provided. A callback is required to read the sensors found")));
+        return;
+    }
+
+    if(!args[2]->IsUndefined() && (!args[2]->IsNumber() || args[2]->NumberValue() < 0)) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate, "Error : the maximum age of the cache should be a duration (number >= 0)")));
+        return;
+    }
+
+    Local<Function> cb = Local<Function>::Cast(args[1]);
+    unsigned maxAge = (args[2]->IsNumber() ? args[2]->NumberValue() : I2C_SCAN_CACHE_MAX_AGE);
+
+    // Get persitent value of the callback, to avoid nodejs deleting it
+    Persistent<Function, CopyablePersistentTraits<Function>> callback(isolate, cb);
+
+    scheduler::scheduler<std::string, sensor::i2cScanResult>* handler =
+    new scheduler::scheduler<std::string, sensor::i2cScanResult>(bus,
+        [maxAge](std::string bus) {
+            return sensor::i2c_scanner::scanOrError(bus, maxAge);
+        },
+        [callback, isolate](std::string bus, sensor::i2cScanResult result) {
+            // Local scope handle
+            HandleScope scope(isolate);
+
+            // Local reference of the callback
+            Local<Function> cb = Local<Function>::New(isolate, callback);
+
+            SendScan(bus, result, isolate, cb);
+        },
+        [callback]() mutable {
+            callback.Reset();
+        });
+    handler->launch();
+}
+
+void BusWrapper::Init(Local<Object> exports) {
+    NODE_SET_METHOD(exports, "stats", Stats);
+    NODE_SET_METHOD(exports, "scan", Scan);
+}
@@ -1,12 +1,17 @@
+#include <vector>
+#include <algorithm>
+
 #include "wrapper_sensor.h"
 
 #ifdef USE_GPIO
-#include "DHT22.h"
-#include "DHT11.h"
+#include "DHT.h"
 #include "PIR.h"
 #endif
 #include "TSL2561.h"
 #include "BMP180.h"
+#include "BMP180_compensation.h"
+#include "TSL2561_lux.h"
+#include "DHT_decoder.h"
 
 using namespace v8;
 
@@ -17,6 +22,16 @@ const struct sensor::sensorConf conf[] = {
         bus     : sensor::GPIO,
         factory : sensor::DHT22_sensor::create
     },
+    {
+        type    : "DHT21",
+        bus     : sensor::GPIO,
+        factory : sensor::DHT21_sensor::create
+    },
+    {
+        type    : "AM2302",
+        bus     : sensor::GPIO,
+        factory : sensor::AM2302_sensor::create
+    },
     {
         type    : "DHT11",
         bus     : sensor::GPIO,
@@ -86,7 +101,7 @@ sensor::sensor* SensorWrapper::InitSensor(const Local<String>& sensorName, const
             }
 
             Local<Number> propValue = Local<Number>::Cast(sensorConfig->Get(prop));
-            sensor::sensor *s = conf[i].factory((int)propValue->NumberValue(), name);
+            sensor::sensor *s = conf[i].factory((int)propValue->NumberValue(), name, InitOptions(sensorConfig, conf[i].bus));
 
             return s;
         }
@@ -98,6 +113,143 @@ sensor::sensor* SensorWrapper::InitSensor(const Local<String>& sensorName, const
     return nullptr;
 }
 
+int SensorWrapper::InitPackage(const Local<Value>& value) {
+    if(!value->IsString())
+        return -1;
+
+    String::Utf8Value packageValue(value->ToString());
+    const std::string package = std::string(*packageValue);
+
+    if(package == "T" || package == "FN" || package == "CL")
+        return sensor::PACKAGE_T;
+    if(package == "CS")
+        return sensor::PACKAGE_CS;
+
+    return -1;
+}
+
+sensor::sensorOptions SensorWrapper::InitOptions(const Local<Object>& sensorConfig, sensor::sensorType type) {
+    Isolate* isolate = Isolate::GetCurrent();
+    sensor::sensorOptions options;
+
+    // I2C bus or GPIO backend, either a bus (or chip) number or the path of its file
+    const Local<String> bus = String::NewFromUtf8(isolate, "bus");
+
+    if(sensorConfig->Has(bus)) {
+        const Local<Value> busValue = sensorConfig->Get(bus);
+
+        if(busValue->IsNumber() && busValue->NumberValue() >= 0) {
+            options.bus = fmt::format(type == sensor::GPIO ? "/dev/gpiochip{0}" : "/dev/i2c-{0}", (int) busValue->NumberValue());
+        } else if(busValue->IsString()) {
+            String::Utf8Value value(busValue->ToString());
+            options.bus = std::string(*value);
+        } else {
+            throw Exception::TypeError(
+                String::NewFromUtf8(isolate, "Error : the bus property should be a bus number (number >= 0) or a bus file"));
+        }
+    }
+
+    // TCA9548A multiplexer, as its address and the channel of the sensor
+    const Local<String> mux = String::NewFromUtf8(isolate, "mux");
+    const Local<String> channel = String::NewFromUtf8(isolate, "channel");
+
+    if(sensorConfig->Has(mux) || sensorConfig->Has(channel)) {
+        if(!sensorConfig->Get(mux)->IsNumber() || sensorConfig->Get(mux)->NumberValue() < 0 ||
+           !sensorConfig->Get(channel)->IsNumber() || sensorConfig->Get(channel)->NumberValue() < 0 ||
+           sensorConfig->Get(channel)->NumberValue() > 7) {
+            throw Exception::TypeError(
+                String::NewFromUtf8(isolate, "Error : a sensor behind a multiplexer requires a valid mux address (number >= 0x0) and channel (number between 0 and 7)"));
+        }
+
+        options.mux = (int) sensorConfig->Get(mux)->NumberValue();
+        options.channel = (int) sensorConfig->Get(channel)->NumberValue();
+    }
+
+    // Oversampling of BMP180 sensors
+    const Local<String> oversampling = String::NewFromUtf8(isolate, "oversampling");
+
+    if(sensorConfig->Has(oversampling)) {
+        if(!sensorConfig->Get(oversampling)->IsNumber() || sensorConfig->Get(oversampling)->NumberValue() < 0 ||
+           sensorConfig->Get(oversampling)->NumberValue() > 3) {
+            throw Exception::TypeError(
+                String::NewFromUtf8(isolate, "Error : the oversampling property should be a number between 0 (ultra low power) and 3 (ultra high resolution)"));
+        }
+
+        options.oversampling = (int) sensorConfig->Get(oversampling)->NumberValue();
+    }
+
+    // Reuse of the temperature compensation of BMP180 sensors, as a number of pressure samples and a maximum age
+    const Local<String> temperatureRefresh = String::NewFromUtf8(isolate, "temperatureRefresh");
+    const Local<String> temperatureMaxAge = String::NewFromUtf8(isolate, "temperatureMaxAge");
+
+    if(sensorConfig->Has(temperatureRefresh)) {
+        if(!sensorConfig->Get(temperatureRefresh)->IsNumber() || sensorConfig->Get(temperatureRefresh)->NumberValue() < 1) {
+            throw Exception::TypeError(
+                String::NewFromUtf8(isolate, "Error : the temperatureRefresh property should be a number of samples (number >= 1)"));
+        }
+
+        options.temperatureRefresh = (unsigned) sensorConfig->Get(temperatureRefresh)->NumberValue();
+    }
+
+    if(sensorConfig->Has(temperatureMaxAge)) {
+        if(!sensorConfig->Get(temperatureMaxAge)->IsNumber() || sensorConfig->Get(temperatureMaxAge)->NumberValue() < 0) {
+            throw Exception::TypeError(
+                String::NewFromUtf8(isolate, "Error : the temperatureMaxAge property should be a duration in seconds (number >= 0)"));
+        }
+
+        options.temperatureMaxAge = (unsigned) (sensorConfig->Get(temperatureMaxAge)->NumberValue() * 1000);
+    }
+
+    // Package of TSL2561 sensors
+    const Local<String> package = String::NewFromUtf8(isolate, "package");
+
+    if(sensorConfig->Has(package)) {
+        options.package = InitPackage(sensorConfig->Get(package));
+
+        if(options.package < 0) {
+            throw Exception::TypeError(
+                String::NewFromUtf8(isolate, "Error : the package property should be 'T', 'FN', 'CL' or 'CS'"));
+        }
+    }
+
+    // Event mode of TSL2561 sensors, as the pin of their interrupt line and the variation of the light triggering an event
+    const Local<String> interruptPin = String::NewFromUtf8(isolate, "interruptPin");
+    const Local<String> threshold = String::NewFromUtf8(isolate, "threshold");
+
+    if(sensorConfig->Has(interruptPin)) {
+        if(!sensorConfig->Get(interruptPin)->IsNumber() || sensorConfig->Get(interruptPin)->NumberValue() < 0) {
+            throw Exception::TypeError(
+                String::NewFromUtf8(isolate, "Error : the interruptPin property should be a valid pin (number >= 0)"));
+        }
+
+        options.interruptPin = (int) sensorConfig->Get(interruptPin)->NumberValue();
+    }
+
+    if(sensorConfig->Has(threshold)) {
+        if(!sensorConfig->Get(threshold)->IsNumber() || sensorConfig->Get(threshold)->NumberValue() < 1 ||
+           sensorConfig->Get(threshold)->NumberValue() > 100) {
+            throw Exception::TypeError(
+                String::NewFromUtf8(isolate, "Error : the threshold property should be a percentage (number between 1 and 100)"));
+        }
+
+        options.threshold = (unsigned) sensorConfig->Get(threshold)->NumberValue();
+    }
+
+    // Maximum age of the last good values of DHT sensors, returned when their reads fail
+    const Local<String> lastGood = String::NewFromUtf8(isolate, "lastGood");
+
+    if(sensorConfig->Has(lastGood)) {
+        if(!sensorConfig->Get(lastGood)->IsNumber() || sensorConfig->Get(lastGood)->NumberValue() < 0) {
+            throw Exception::TypeError(
+                String::NewFromUtf8(isolate, "Error : the lastGood property should be a duration in seconds (number >= 0)"));
+        }
+
+        options.lastGood = (unsigned) (sensorConfig->Get(lastGood)->NumberValue() * 1000);
+    }
+
+    return options;
+}
+
 void SensorWrapper::SendError(sensor::sensor* s, sensor::sensorException& e, Isolate* isolate, Local<Function>& cb) {
     Local<Object> result = Object::New(isolate);
 
@@ -107,6 +259,9 @@ void SensorWrapper::SendError(sensor::sensor* s, sensor::sensorException& e, Iso
     result->Set(String::NewFromUtf8(isolate, "cause"), cause);
     result->Set(String::NewFromUtf8(isolate, "code"), code);
 
+    if(e.systemError())
+        result->Set(String::NewFromUtf8(isolate, "errno"), Number::New(isolate, e.systemError()));
+
     // Call the callback with the values
     Local<Value> argv[2] = { result, Undefined(isolate) };
     cb->Call(isolate->GetCurrentContext()->Global(), 2, argv);
@@ -167,6 +322,15 @@ void SensorWrapper::SendResult(sensor::sensor* s, sensor::result& r, Isolate* is
     result->Set(String::NewFromUtf8(isolate, "sensor_name"), String::NewFromUtf8(isolate, s->getName().c_str()));
     result->Set(String::NewFromUtf8(isolate, "sensor_type"), String::NewFromUtf8(isolate, s->getType().c_str()));
 
+    // Last good value returned in place of a failed read, with its age (ms)
+    if(r.isStale()) {
+        long long now = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+        result->Set(String::NewFromUtf8(isolate, "stale"), Boolean::New(isolate, true));
+        result->Set(String::NewFromUtf8(isolate, "age"), Number::New(isolate, now - r.getTimestamp()));
+    }
+
     // Call the callback with the values
     Local<Value> argv[2] = { Undefined(isolate), result };
     cb->Call(isolate->GetCurrentContext()->Global(), 2, argv);
@@ -227,6 +391,11 @@ void SensorWrapper::fetch(const FunctionCallbackInfo<Value>& args, bool repeatab
             callback.Reset();
             sensorWrapperObj.Reset();
         }, value, repeatable);
+
+    // Failed reads asking to be retried are rescheduled, instead of being reported
+    handler->setRetry([](sensor::sensor*, sensor::resultsOrError& results) {
+        return results.getRetryDelay();
+    });
     handler->launch();
 
     // Also keep track of the sheduler
@@ -250,6 +419,11 @@ void SensorWrapper::Init(Local<Object> exports) {
 
     constructor.Reset(isolate, tpl->GetFunction());
     exports->Set(String::NewFromUtf8(isolate, "Sensor"), tpl->GetFunction());
+
+    // Raw values compensation
+    NODE_SET_METHOD(exports, "compensateBMP180", CompensateBMP180);
+    NODE_SET_METHOD(exports, "luxTSL2561", LuxTSL2561);
+    NODE_SET_METHOD(exports, "decodeDHT", DecodeDHT);
 }
 
 void SensorWrapper::New(const FunctionCallbackInfo<Value>& args) {
@@ -273,6 +447,10 @@ void SensorWrapper::New(const FunctionCallbackInfo<Value>& args) {
         } catch(Local<Value> &e) {
             // Transfer the exception to node
             isolate->ThrowException(e);
+        } catch(sensor::sensorException &e) {
+            // The sensor could not be created with this configuration (e.g. invalid bus or trace)
+            isolate->ThrowException(Exception::Error(
+                String::NewFromUtf8(isolate, fmt::format("Error : {0}", e.std::runtime_error::what()).c_str())));
         }
     } else {
         // Invoked as plain function, turn into construct call.
@@ -297,3 +475,187 @@ void SensorWrapper::FetchClear(const FunctionCallbackInfo<Value>& args) {
     SensorWrapper* sensorWrapper = ObjectWrap::Unwrap<SensorWrapper>(args.Holder());
     sensorWrapper->fetchClear();
 }
+
+void SensorWrapper::CompensateBMP180(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+
+    if(!args[0]->IsObject() || !args[1]->IsArray() || !args[2]->IsArray()) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate, "Error : a calibration object, and the arrays of raw temperatures and pressures are required")));
+        return;
+    }
+
+    const Local<Object> calibrationObj = args[0]->ToObject();
+    const Local<Array> ut = Local<Array>::Cast(args[1]);
+    const Local<Array> up = Local<Array>::Cast(args[2]);
+    int oss = (args[3]->IsNumber() ? args[3]->NumberValue() : 0);
+
+    if(ut->Length() != up->Length() || oss < 0 || oss > 3) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate, "Error : the arrays of raw values should have the same length, and the oversampling be between 0 and 3")));
+        return;
+    }
+
+    // Calibration data, from ac1 to md
+    static const char* names[11] = { "ac1", "ac2", "ac3", "ac4", "ac5", "ac6", "b1", "b2", "mb", "mc", "md" };
+    int32_t words[11];
+
+    for(int i = 0; i < 11; i++) {
+        const Local<Value> word = calibrationObj->Get(String::NewFromUtf8(isolate, names[i]));
+
+        if(!word->IsNumber()) {
+            isolate->ThrowException(Exception::TypeError(
+                String::NewFromUtf8(isolate, fmt::format("Error : the calibration property '{0}' is required", names[i]).c_str())));
+            return;
+        }
+
+        words[i] = (int32_t) word->NumberValue();
+
+        // As read from the sensor, a word should never be 0x0000 or 0xFFFF
+        if((uint16_t) words[i] == 0x0000 || (uint16_t) words[i] == 0xFFFF) {
+            isolate->ThrowException(Exception::TypeError(
+                String::NewFromUtf8(isolate, fmt::format("Error : invalid calibration property '{0}' : 0x{1:04x}", names[i], (uint16_t) words[i]).c_str())));
+            return;
+        }
+    }
+
+    sensor::bmp180Calibration calibration = {
+        (int16_t) words[0], (int16_t) words[1], (int16_t) words[2], (uint16_t) words[3], (uint16_t) words[4], (uint16_t) words[5],
+        (int16_t) words[6], (int16_t) words[7], (int16_t) words[8], (int16_t) words[9], (int16_t) words[10]
+    };
+
+    // Compensate every sample at once
+    const size_t count = ut->Length();
+    std::vector<int32_t> rawTemperatures(count), rawPressures(count), pressures(count);
+    std::vector<float> temperatures(count);
+
+    for(size_t i = 0; i < count; i++) {
+        rawTemperatures[i] = (int32_t) ut->Get(i)->NumberValue();
+        rawPressures[i] = (int32_t) up->Get(i)->NumberValue();
+
+        // A division by 0 would kill the process
+        if(!sensor::BMP180_compensation::isComputable(calibration, rawTemperatures[i])) {
+            isolate->ThrowException(Exception::TypeError(
+                String::NewFromUtf8(isolate, fmt::format("Error : the raw temperature {0} (index {1}) can't be compensated with this calibration",
+                                                         rawTemperatures[i], i).c_str())));
+            return;
+        }
+    }
+
+    sensor::BMP180_compensation::compensate(calibration, (uint16_t) oss, count, rawTemperatures.data(), rawPressures.data(),
+                                            temperatures.data(), pressures.data());
+
+    Local<Object> result = Object::New(isolate);
+    Local<Array> temperature = Array::New(isolate, count);
+    Local<Array> pressure = Array::New(isolate, count);
+
+    for(size_t i = 0; i < count; i++) {
+        temperature->Set(i, Number::New(isolate, temperatures[i]));
+        pressure->Set(i, Number::New(isolate, pressures[i]));
+    }
+
+    result->Set(String::NewFromUtf8(isolate, "temperature"), temperature);
+    result->Set(String::NewFromUtf8(isolate, "pressure"), pressure);
+
+    args.GetReturnValue().Set(result);
+}
+
+void SensorWrapper::LuxTSL2561(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+
+    if(!args[0]->IsArray() || !args[1]->IsArray()) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate, "Error : the arrays of raw broadband and infrared channels are required")));
+        return;
+    }
+
+    const Local<Array> channel0 = Local<Array>::Cast(args[0]);
+    const Local<Array> channel1 = Local<Array>::Cast(args[1]);
+
+    // Gain (1 or 16), integration time (13.7, 101 or 402ms) and package of the sensor
+    int gain = (args[2]->IsNumber() ? args[2]->NumberValue() : 16);
+    double integrationTime = (args[3]->IsNumber() ? args[3]->NumberValue() : 402);
+    int package = (args[4]->IsUndefined() ? (int) sensor::PACKAGE_CS : InitPackage(args[4]));
+    int timing = (integrationTime == 13.7 ? sensor::TIMING_13MS : integrationTime == 101 ? sensor::TIMING_101MS :
+                  integrationTime == 402 ? sensor::TIMING_402MS : -1);
+
+    if(channel0->Length() != channel1->Length() || (gain != 1 && gain != 16) || timing < 0 || package < 0) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate, "Error : the arrays of channels should have the same length, the gain be 1 or 16, the integration time 13.7, 101 or 402, and the package 'T', 'FN', 'CL' or 'CS'")));
+        return;
+    }
+
+    // Convert every sample at once
+    const size_t count = channel0->Length();
+    std::vector<uint32_t> broadband(count), infrared(count), lux(count);
+
+    for(size_t i = 0; i < count; i++) {
+        broadband[i] = (uint32_t) channel0->Get(i)->NumberValue();
+        infrared[i] = (uint32_t) channel1->Get(i)->NumberValue();
+    }
+
+    sensor::TSL2561_lux::compute((sensor::tsl2561Package) package, (sensor::tsl2561Timing) timing, gain == 16 ? 1 : 0, count,
+                                 broadband.data(), infrared.data(), lux.data());
+
+    Local<Array> result = Array::New(isolate, count);
+
+    for(size_t i = 0; i < count; i++)
+        result->Set(i, Number::New(isolate, lux[i]));
+
+    args.GetReturnValue().Set(result);
+}
+
+void SensorWrapper::DecodeDHT(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+
+    if(!args[0]->IsArray()) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate, "Error : the array of captures, each being an array of pulse widths, is required")));
+        return;
+    }
+
+    // Copy the captures, as a DHT sensor would capture them
+    const Local<Array> values = Local<Array>::Cast(args[0]);
+    const size_t count = values->Length();
+    std::vector<sensor::dhtCapture> captures(count);
+
+    for(size_t i = 0; i < count; i++) {
+        if(!values->Get(i)->IsArray()) {
+            isolate->ThrowException(Exception::TypeError(
+                String::NewFromUtf8(isolate, "Error : each capture should be an array of pulse widths")));
+            return;
+        }
+
+        // The data bits being the last pulses, only the last ones of a longer capture are kept
+        const Local<Array> widths = Local<Array>::Cast(values->Get(i));
+        const uint32_t skipped = widths->Length() - std::min(widths->Length(), (uint32_t) DHT_PULSES);
+        captures[i].count = widths->Length() - skipped;
+
+        for(unsigned j = 0; j < captures[i].count; j++)
+            captures[i].widths[j] = (unsigned) widths->Get(skipped + j)->NumberValue();
+    }
+
+    // Decode every capture at once
+    std::vector<sensor::dhtFrame> frames(count);
+
+    for(size_t i = 0; i < count; i++)
+        frames[i] = sensor::DHT_decoder::decode(captures[i]);
+
+    Local<Array> result = Array::New(isolate, count);
+
+    for(size_t i = 0; i < count; i++) {
+        Local<Object> frame = Object::New(isolate);
+        Local<Array> data = Array::New(isolate, 5);
+
+        for(unsigned j = 0; j < 5; j++)
+            data->Set(j, Number::New(isolate, frames[i].data[j]));
+
+        frame->Set(String::NewFromUtf8(isolate, "data"), data);
+        frame->Set(String::NewFromUtf8(isolate, "valid"), Boolean::New(isolate, frames[i].valid));
+        frame->Set(String::NewFromUtf8(isolate, "confidence"), Number::New(isolate, frames[i].confidence));
+
+        result->Set(i, frame);
+    }
+
+    args.GetReturnValue().Set(result);
+}
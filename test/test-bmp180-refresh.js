@@ -0,0 +1,63 @@
+// Load raspi-sensors plugin
+var RaspiSensors = require('../build/raspi-sensors');
+
+console.log('raspi-sensors BMP180 temperature refresh test v0.2');
+
+// Simulated BMP180s, reusing their temperature compensation either for a duration or for a number of
+// samples. No raspberry needed
+var byAge = new RaspiSensors.Sensor({
+	type              : "BMP180",
+	address           : 0x77,
+	bus               : "sim",
+	temperatureMaxAge : 60 // Measure the temperature at least every minute
+}, "pressure_sensor");
+
+var bySamples = new RaspiSensors.Sensor({
+	type               : "BMP180",
+	address            : 0x77,
+	bus                : "sim",
+	temperatureRefresh : 4 // Measure the temperature every 4 pressure samples
+}, "pressure_sensor_2");
+
+var count = 10;
+
+// Fetch the sensor several times, and count the temperature conversions (only returned when measured)
+function countConversions(sensor, fetches, callback) {
+	var conversions = 0;
+	var pressures = 0;
+
+	sensor.fetch(function next(err, data) {
+		if(err) {
+			console.error(err.cause);
+			process.exit(1);
+		}
+
+		if(data.type == "Temperature") {
+			conversions++;
+			return;
+		}
+
+		if(++pressures < fetches)
+			sensor.fetch(next);
+		else
+			callback(conversions);
+	});
+}
+
+countConversions(byAge, count, function(conversions) {
+	console.log("temperatureMaxAge alone : " + conversions + " temperature conversions for " + count + " samples");
+
+	if(conversions != 1) {
+		console.error("The temperature should only be measured once");
+		process.exit(1);
+	}
+
+	countConversions(bySamples, count, function(conversions) {
+		console.log("temperatureRefresh alone : " + conversions + " temperature conversions for " + count + " samples");
+
+		if(conversions != Math.ceil(count / 4)) {
+			console.error("The temperature should be measured every 4 samples");
+			process.exit(1);
+		}
+	});
+});
@@ -0,0 +1,69 @@
+// Load raspi-sensors plugin
+var RaspiSensors = require('../build/raspi-sensors');
+
+console.log('raspi-sensors BMP180 compensation test v0.2');
+
+// Calibration data of the datasheet example
+var calibration = {
+	ac1 : 408,
+	ac2 : -72,
+	ac3 : -14383,
+	ac4 : 32741,
+	ac5 : 32757,
+	ac6 : 23153,
+	b1  : 6190,
+	b2  : 4,
+	mb  : -32768,
+	mc  : -8711,
+	md  : 2868
+};
+
+// The datasheet example : 15.0°C and 69964Pa are expected
+var golden = RaspiSensors.compensateBMP180(calibration, [ 27898 ], [ 23843 ], 0);
+
+if(golden.temperature[0] !== 15 || golden.pressure[0] !== 69964) {
+	console.error("Unexpected compensation of the datasheet example!");
+	console.error(golden);
+	process.exit(1);
+}
+
+console.log("Datasheet example compensated : " + golden.temperature[0] + "°C, " + golden.pressure[0] + "Pa");
+
+// Compensate a day of samples, taken every 100ms
+var count = 864000;
+var ut = new Array(count);
+var up = new Array(count);
+
+for(var i = 0; i < count; i++) {
+	ut[i] = 27898 + (i % 1000);
+	up[i] = 23843 + (i % 5000);
+}
+
+var start = process.hrtime();
+var result = RaspiSensors.compensateBMP180(calibration, ut, up, 0);
+var duration = process.hrtime(start);
+
+console.log(count + " samples compensated in " + (duration[0] * 1e3 + duration[1] / 1e6).toFixed(1) + "ms");
+console.log("Last sample : " + result.temperature[count - 1] + "°C, " + result.pressure[count - 1] + "Pa");
+
+// Calibrations dividing by 0 are rejected, instead of killing the process
+function rejected(changes, ut) {
+	var invalid = {};
+
+	for(var name in calibration)
+		invalid[name] = (name in changes ? changes[name] : calibration[name]);
+
+	try {
+		RaspiSensors.compensateBMP180(invalid, [ ut ], [ 23843 ], 0);
+	} catch(e) {
+		console.log("Rejected : " + e.message);
+		return;
+	}
+
+	console.error("Invalid calibration accepted : " + JSON.stringify(changes));
+	process.exit(1);
+}
+
+rejected({ ac4 : 0 }, 27898);
+rejected({ ac5 : 0xFFFF }, 27898);
+rejected({ md : -4743 }, 27898); // x1 + md == 0
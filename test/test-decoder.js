@@ -0,0 +1,74 @@
+// Load raspi-sensors plugin
+var RaspiSensors = require('../build/raspi-sensors');
+
+console.log('raspi-sensors DHT decoder test v0.2');
+
+// Pulses of an answer : the release of the pin, the acknowledgment, then the 40 bits of the bytes
+function capture(bytes, jitter) {
+	var widths = [ 30, 80 ];
+
+	for(var i = 0; i < 40; i++) {
+		var one = (bytes[Math.floor(i / 8)] >> (7 - i % 8)) & 1;
+		widths.push((one ? 70 : 27) + Math.round((Math.random() * 2 - 1) * jitter));
+	}
+
+	return widths;
+}
+
+// Known answer : 45.5% and 21.3°C from a DHT22
+var frame = RaspiSensors.decodeDHT([ capture([ 0x01, 0xC7, 0x00, 0xD5, 0x9D ], 0) ])[0];
+
+if(!frame.valid || frame.confidence !== 1 || frame.data.join(",") !== "1,199,0,213,157") {
+	console.error("Unexpected decoding : " + JSON.stringify(frame));
+	process.exit(1);
+}
+
+console.log("Known answer checked");
+
+// Longer capture, with extra pulses before the answer : only the last pulses hold the data bits
+frame = RaspiSensors.decodeDHT([ [ 5, 12, 8 ].concat(capture([ 0x01, 0xC7, 0x00, 0xD5, 0x9D ], 0)) ])[0];
+
+if(!frame.valid || frame.data.join(",") !== "1,199,0,213,157") {
+	console.error("Unexpected decoding of a longer capture : " + JSON.stringify(frame));
+	process.exit(1);
+}
+
+console.log("Longer capture checked");
+
+// Random captures, of random lengths : nothing should fail, and the confidence stay in [0, 1]
+var count = 100000;
+var captures = new Array(count);
+
+for(var i = 0; i < count; i++) {
+	captures[i] = new Array(Math.floor(Math.random() * 50));
+
+	for(var j = 0; j < captures[i].length; j++)
+		captures[i][j] = Math.floor(Math.random() * 200);
+}
+
+var valid = 0;
+
+RaspiSensors.decodeDHT(captures).forEach(function(frame) {
+	if(frame.confidence < 0 || frame.confidence > 1) {
+		console.error("Unexpected confidence : " + JSON.stringify(frame));
+		process.exit(1);
+	}
+
+	valid += frame.valid ? 1 : 0;
+});
+
+console.log(count + " random captures decoded, " + valid + " passing the checksum by chance");
+
+// Decode captures with an increasing jitter
+[ 0, 5, 10, 15, 20, 25, 30 ].forEach(function(jitter) {
+	for(var i = 0; i < count; i++)
+		captures[i] = capture([ 0x01, 0xC7, 0x00, 0xD5, 0x9D ], jitter);
+
+	var start = process.hrtime();
+	var frames = RaspiSensors.decodeDHT(captures);
+	var duration = process.hrtime(start);
+	var valid = frames.filter(function(frame) { return frame.valid; }).length;
+
+	console.log("Jitter of " + jitter + "us : " + valid + "/" + count + " valid, decoded in " +
+	            (duration[0] * 1e3 + duration[1] / 1e6).toFixed(1) + "ms");
+});
@@ -0,0 +1,60 @@
+// Load raspi-sensors plugin
+var RaspiSensors = require('../build/raspi-sensors');
+
+console.log('raspi-sensors DHT retry test v0.2');
+
+// Simulated DHT22 answering only one start signal out of 6, i.e. failing more times in a row than the
+// retries of a fetch. No raspberry needed
+var DHT22 = new RaspiSensors.Sensor({
+	type     : "DHT22",
+	pin      : 2,
+	bus      : "sim",
+	lastGood : 60 // Values of the past minute in place of a failed read
+}, "intermittent_sensor");
+
+function check(condition, message) {
+	if(!condition) {
+		console.error(message);
+		process.exit(1);
+	}
+}
+
+// Fetch once, and provide every result received to the callback
+function fetchAll(callback) {
+	var results = [];
+
+	DHT22.fetch(function(err, data) {
+		check(!err, "Unexpected error : " + JSON.stringify(err));
+		results.push(data);
+
+		if(results.length == 2)
+			callback(results);
+	});
+}
+
+// The first read is answered
+fetchAll(function(results) {
+	results.forEach(function(data) {
+		check(!data.stale, "Unexpected stale value : " + JSON.stringify(data));
+	});
+
+	console.log("Good values read");
+
+	// The next reads all fail : the fetch is retried once every 2s without reporting the failures, until
+	// the last good values are returned instead
+	var start = Date.now();
+
+	fetchAll(function(results) {
+		var duration = Date.now() - start;
+
+		results.forEach(function(data) {
+			check(data.stale === true && data.age >= 9000, "Expected a stale value : " + JSON.stringify(data));
+		});
+
+		check(duration >= 9000, "Retried too fast : " + duration + "ms");
+
+		console.log("Stale values returned after " + duration + "ms of retries");
+	});
+});
+
+console.log('Control send back to the main thread');
@@ -0,0 +1,53 @@
+// Load raspi-sensors plugin
+var RaspiSensors = require('../build/raspi-sensors');
+
+console.log('raspi-sensors simulated GPIO test v0.2');
+
+// Create some sensors, on simulated pins with a 5us jitter. No raspberry needed
+var DHT22 = new RaspiSensors.Sensor({
+	type     : "DHT22",
+	pin      : 7,
+	bus      : "sim:5",
+	lastGood : 30 // Values of the past 30s in place of a failed read
+}, "temp_sensor");
+
+var DHT11 = new RaspiSensors.Sensor({
+	type : "DHT11",
+	pin  : 0,
+	bus  : "sim:5"
+}, "temp_sensor_2");
+
+var PIR = new RaspiSensors.Sensor({
+	type : "PIR",
+	pin  : 1,
+	bus  : "sim:5"
+}, "motion_sensor");
+
+// Define a callback
+var dataLog = function(err, data) {
+	if(err) {
+		console.error("An error occured!");
+		console.error(err.cause);
+		return;
+	}
+
+	// Only log for now
+	console.log(data);
+}
+
+// The simulated DHT22 measures 45.5% and 21.3°C, the DHT11 45% and 21°C, and the PIR detects
+// a motion during 3s every 10s
+DHT22.fetchInterval(dataLog, 2);
+DHT11.fetchInterval(dataLog, 2);
+PIR.fetchInterval(dataLog, 1);
+
+// After 12s of logging, stop everything
+setTimeout(function() {
+	console.log("Time to stop the logging of values!");
+
+	DHT22.fetchClear();
+	DHT11.fetchClear();
+	PIR.fetchClear();
+}, 12000)
+
+console.log('Control send back to the main thread');
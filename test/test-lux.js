@@ -0,0 +1,90 @@
+// Load raspi-sensors plugin
+var RaspiSensors = require('../build/raspi-sensors');
+
+console.log('raspi-sensors TSL2561 lux test v0.2');
+
+// Known conversions : broadband and infrared channels, gain, integration time, package, and the lux expected
+var golden = [
+	[ 16000, 4800, 16, 402,  "CS", 327 ],
+	[ 16000, 4800, 16, 402,  "T",  300 ],
+	[ 1020,  306,  1,  13.7, "CS", 9765 ],
+	[ 1000,  2000, 16, 101,  "T",  0 ]     // More infrared than broadband
+];
+
+golden.forEach(function(g) {
+	var lux = RaspiSensors.luxTSL2561([ g[0] ], [ g[1] ], g[2], g[3], g[4])[0];
+
+	if(lux !== g[5]) {
+		console.error("Unexpected conversion of " + g.slice(0, 5).join(", ") + " : " + lux + " instead of " + g[5]);
+		process.exit(1);
+	}
+});
+
+console.log(golden.length + " known conversions checked");
+
+// Previous runtime computation, to check that the specialized conversion gives the same values :
+// coefficients selected by comparisons, and the channel scale computed for every sample. Unsigned
+// 32 bits arithmetic, as in C
+var previousSegments = {
+	T  : [ [ 0x0040, 0x01f2, 0x01be ], [ 0x0080, 0x0214, 0x02d1 ], [ 0x00c0, 0x023f, 0x037b ], [ 0x0100, 0x0270, 0x03fe ],
+	       [ 0x0138, 0x016f, 0x01fc ], [ 0x019a, 0x00d2, 0x00fb ], [ 0x029a, 0x0018, 0x0012 ] ],
+	CS : [ [ 0x0043, 0x0204, 0x01ad ], [ 0x0085, 0x0228, 0x02c1 ], [ 0x00c8, 0x0253, 0x0363 ], [ 0x010a, 0x0282, 0x03df ],
+	       [ 0x014d, 0x0177, 0x01dd ], [ 0x019a, 0x0101, 0x0127 ], [ 0x029a, 0x0037, 0x002b ] ]
+};
+
+function previousLux(channel0, channel1, gain, integration, package) {
+	var chScale = (integration == 13.7 ? 0x7517 : (integration == 101 ? 0x0fe7 : 1 << 10));
+	var segments = previousSegments[package == "CS" ? "CS" : "T"];
+	var b = 0, m = 0;
+
+	if(gain == 1)
+		chScale = chScale << 4; // scale 1X to 16X
+
+	channel0 = Math.imul(channel0, chScale) >>> 10;
+	channel1 = Math.imul(channel1, chScale) >>> 10;
+
+	var ratio1 = (channel0 != 0 ? Math.floor(((channel1 << 10) >>> 0) / channel0) : 0);
+	var ratio = ((ratio1 + 1) >>> 1) & 0xFFFF;
+
+	for(var i = 0; i < segments.length; i++) {
+		if(ratio <= segments[i][0]) {
+			b = segments[i][1];
+			m = segments[i][2];
+			break;
+		}
+	}
+
+	var broadband = Math.imul(channel0, b) >>> 0;
+	var infrared = Math.imul(channel1, m) >>> 0;
+
+	if(infrared > broadband)
+		return 0;
+
+	return ((broadband - infrared + (1 << 13)) >>> 0) >>> 14;
+}
+
+// Convert a day of samples, taken every 100ms
+var count = 864000;
+var channel0 = new Array(count);
+var channel1 = new Array(count);
+
+for(var i = 0; i < count; i++) {
+	channel0[i] = 1000 + (i % 30000);
+	channel1[i] = 300 + (i % 9000);
+}
+
+var start = process.hrtime();
+var lux = RaspiSensors.luxTSL2561(channel0, channel1, 16, 402, "T");
+var duration = process.hrtime(start);
+
+for(var i = 0; i < count; i++) {
+	var previous = previousLux(channel0[i], channel1[i], 16, 402, "T");
+
+	if(lux[i] !== previous) {
+		console.error("Sample " + i + " : " + lux[i] + " lux instead of " + previous + " with the previous computation");
+		process.exit(1);
+	}
+}
+
+console.log(count + " samples converted in " + (duration[0] * 1e3 + duration[1] / 1e6).toFixed(1) + "ms, as with the previous computation");
+console.log("Last sample : " + lux[count - 1] + " lux");
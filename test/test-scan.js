@@ -0,0 +1,57 @@
+// Load raspi-sensors plugin
+var RaspiSensors = require('../build/raspi-sensors');
+
+console.log('raspi-sensors bus scan test v0.2');
+
+// Define a callback
+var dataLog = function(err, data) {
+	if(err) {
+		console.error("An error occured!");
+		console.error(err.cause);
+		return;
+	}
+
+	// Only log for now
+	console.log(data);
+}
+
+// Scan the simulated bus : a TSL2561 at 0x39 and a BMP180 at 0x77 are expected
+RaspiSensors.scan("sim:400", function(err, configs) {
+	if(err) {
+		console.error("An error occured!");
+		console.error(err.cause);
+		return;
+	}
+
+	console.log(configs);
+
+	// The simulated TSL2561 has the T package
+	configs.forEach(function(config) {
+		if(config.type == "TSL2561" && config.package != "T") {
+			console.error("Unexpected package : " + JSON.stringify(config));
+			process.exit(1);
+		}
+	});
+
+	// Create and read every sensor found
+	var addresses = configs.map(function(config) { return config.address; });
+
+	configs.forEach(function(config) {
+		new RaspiSensors.Sensor(config, config.type + "_" + config.address).fetch(function(err, data) {
+			dataLog(err, data);
+
+			// The probes of the scan are not accounted : only the devices read have statistics
+			RaspiSensors.stats()["sim:400"].devices.forEach(function(device) {
+				if(addresses.indexOf(device.address) < 0) {
+					console.error("Unexpected device statistics : " + JSON.stringify(device));
+					process.exit(1);
+				}
+			});
+		});
+	});
+});
+
+// Scan the default bus, always probing it
+RaspiSensors.scan(undefined, dataLog, 0);
+
+console.log('Control send back to the main thread');
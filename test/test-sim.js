@@ -0,0 +1,59 @@
+// Load raspi-sensors plugin
+var RaspiSensors = require('../build/raspi-sensors');
+
+console.log('raspi-sensors simulated bus test v0.2');
+
+// Create some sensors, on a simulated i2c bus clocked at 400kHz. No raspberry needed
+var TSL2561 = new RaspiSensors.Sensor({
+	type    : "TSL2561",
+	address : 0X39,
+	bus     : "sim:400"
+}, "light_sensor");
+
+var BMP180 = new RaspiSensors.Sensor({
+	type    : "BMP180",
+	address : 0x77,
+	bus     : "sim:400"
+}, "temp_sensor");
+
+// Invalid buses are reported as errors, instead of aborting the process
+[ "sim:4x", "replay:/nonexistent/trace.bin" ].forEach(function(bus) {
+	try {
+		new RaspiSensors.Sensor({ type : "BMP180", address : 0x77, bus : bus }, "invalid_sensor");
+	} catch(e) {
+		console.log("Rejected bus '" + bus + "' : " + e.message);
+		return;
+	}
+
+	console.error("Invalid bus '" + bus + "' accepted!");
+	process.exit(1);
+});
+
+// Define a callback
+var dataLog = function(err, data) {
+	if(err) {
+		console.error("An error occured!");
+		console.error(err.cause);
+		return;
+	}
+
+	// Only log for now
+	console.log(data);
+}
+
+// The simulated BMP180 holds the datasheet example : 15.0°C and 69964Pa are expected
+BMP180.fetch(dataLog);
+
+// Fetch some value at a certain interval
+TSL2561.fetchInterval(dataLog, 1);
+BMP180.fetchInterval(dataLog, 1);
+
+// After 5s of logging, stop everything
+setTimeout(function() {
+	console.log("Time to stop the logging of values!");
+
+	TSL2561.fetchClear();
+	BMP180.fetchClear();
+}, 5000)
+
+console.log('Control send back to the main thread');
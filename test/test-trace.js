@@ -0,0 +1,69 @@
+// Load raspi-sensors plugin
+var RaspiSensors = require('../build/raspi-sensors');
+var fs = require('fs');
+var os = require('os');
+var path = require('path');
+
+console.log('raspi-sensors trace record and replay test v0.2');
+
+// Record two sensors of a simulated bus, then replay them from the trace. No raspberry needed
+var trace = path.join(os.tmpdir(), 'raspi-sensors-trace.bin');
+var samples = 5;
+
+if(fs.existsSync(trace))
+	fs.unlinkSync(trace);
+
+// Create the sensors of a bus
+function createSensors(bus, suffix) {
+	return [
+		new RaspiSensors.Sensor({ type : "BMP180", address : 0x77, bus : bus }, "pressure_sensor_" + suffix),
+		new RaspiSensors.Sensor({ type : "TSL2561", address : 0x39, bus : bus }, "light_sensor_" + suffix)
+	];
+}
+
+// Fetch every sensor at once, several times, and provide the values of each sensor to the callback
+function fetchAll(sensors, callback) {
+	var values = sensors.map(function() { return []; });
+	var remaining = sensors.length;
+
+	sensors.forEach(function(sensor, i) {
+		var fetches = 0;
+
+		sensor.fetch(function next(err, data) {
+			if(err) {
+				console.error("An error occured!");
+				console.error(err.cause);
+				process.exit(1);
+			}
+
+			values[i].push(data.type + " " + data.value);
+
+			// The BMP180 sends its temperature then its pressure, the TSL2561 only its light
+			if(data.type == "Temperature")
+				return;
+
+			if(++fetches < samples)
+				sensor.fetch(next);
+			else if(--remaining == 0)
+				callback(values);
+		});
+	});
+}
+
+fetchAll(createSensors("record:" + trace + ":sim", "recorded"), function(recorded) {
+	console.log("Recorded : " + JSON.stringify(recorded));
+
+	// The operations of both sensors may be interleaved differently, each one is replayed from its own records
+	fetchAll(createSensors("replay:" + trace, "replayed"), function(replayed) {
+		console.log("Replayed : " + JSON.stringify(replayed));
+
+		if(JSON.stringify(recorded) != JSON.stringify(replayed)) {
+			console.error("The replayed values differ from the recorded ones!");
+			process.exit(1);
+		}
+
+		fs.unlinkSync(trace);
+	});
+});
+
+console.log('Control send back to the main thread');